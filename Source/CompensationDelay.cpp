@@ -0,0 +1,58 @@
+#include "CompensationDelay.h"
+#include "DelayArena.h"
+
+void CompensationDelay::prepare(const juce::dsp::ProcessSpec& spec, int maxDelaySamples)
+{
+    numChannels = juce::jmin(maxChannels, (int)spec.numChannels);
+    maxDelay = juce::jmax(0, maxDelaySamples);
+    size = maxDelay + (int)spec.maximumBlockSize + 1;
+    delay = juce::jmin(delay, maxDelay);
+}
+
+size_t CompensationDelay::getRequiredStorage() const
+{
+    return (size_t)numChannels * DelayArena::alignedSize((size_t)size);
+}
+
+void CompensationDelay::setStorage(float* storage)
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+        channelData[ch] = ch < numChannels ? storage + (size_t)ch * DelayArena::alignedSize((size_t)size) : nullptr;
+
+    reset();
+}
+
+void CompensationDelay::reset()
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        if (channelData[ch] != nullptr)
+            juce::FloatVectorOperations::clear(channelData[ch], size);
+
+    writePos = 0;
+}
+
+void CompensationDelay::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numSamples = (int)block.getNumSamples();
+    const int channels = juce::jmin(numChannels, (int)block.getNumChannels());
+    const int readPos = (writePos - delay + size) % size;
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* io = block.getChannelPointer((size_t)ch);
+        float* ring = channelData[ch];
+
+        const int writeFirst = juce::jmin(numSamples, size - writePos);
+        juce::FloatVectorOperations::copy(ring + writePos, io, writeFirst);
+        juce::FloatVectorOperations::copy(ring, io + writeFirst, numSamples - writeFirst);
+
+        if (delay > 0)
+        {
+            const int readFirst = juce::jmin(numSamples, size - readPos);
+            juce::FloatVectorOperations::copy(io, ring + readPos, readFirst);
+            juce::FloatVectorOperations::copy(io + readFirst, ring, numSamples - readFirst);
+        }
+    }
+
+    writePos = (writePos + numSamples) % size;
+}
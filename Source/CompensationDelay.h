@@ -0,0 +1,32 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+// Whole-sample delay that lines one path up with another carrying latency:
+// the dry signal against the linear-phase EQ on the wet, and the wet itself
+// while that EQ's FIR is still loading. The input is always written, so a
+// change of delay reads valid history straight away.
+//
+// The delay memory lives in the owner's DelayArena, like the other delay lines.
+class CompensationDelay
+{
+public:
+    static constexpr int maxChannels = 2;
+
+    void prepare(const juce::dsp::ProcessSpec& spec, int maxDelaySamples);
+    size_t getRequiredStorage() const;
+    void setStorage(float* storage);
+    void reset();
+
+    void setDelay(int delaySamples) { delay = juce::jlimit(0, maxDelay, delaySamples); }
+    int getDelay() const { return delay; }
+
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    float* channelData[maxChannels] = { nullptr, nullptr };
+    int numChannels = 0;
+    int size = 0;
+    int writePos = 0;
+    int maxDelay = 0;
+    int delay = 0;
+};
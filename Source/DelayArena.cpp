@@ -0,0 +1,23 @@
+#include "DelayArena.h"
+
+void DelayArena::allocate(size_t totalSamples)
+{
+    if (totalSamples != size || base == nullptr)
+    {
+        constexpr size_t pad = alignmentBytes / sizeof(float);
+        block.malloc(totalSamples + pad);
+
+        auto address = reinterpret_cast<std::uintptr_t>(block.get());
+        auto aligned = (address + alignmentBytes - 1) & ~(std::uintptr_t)(alignmentBytes - 1);
+        base = reinterpret_cast<float*>(aligned);
+        size = totalSamples;
+    }
+
+    clear();
+}
+
+void DelayArena::clear()
+{
+    if (base != nullptr)
+        juce::zeromem(base, getSizeInBytes());
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+// One contiguous, SIMD-aligned block holding all delay memory of an instance.
+// Owners size their regions in prepare(), the arena is allocated once for the
+// sum, and each owner is handed its slice in signal-chain order.
+class DelayArena
+{
+public:
+    static constexpr size_t alignmentBytes = 64; // cache line; also covers AVX-512 loads
+
+    // Rounds a region up so the region after it starts on an alignment boundary.
+    static size_t alignedSize(size_t numSamples)
+    {
+        constexpr size_t step = alignmentBytes / sizeof(float);
+        return (numSamples + step - 1) / step * step;
+    }
+
+    // Reallocates only when the total changes; the contents are always zeroed.
+    void allocate(size_t totalSamples);
+
+    float* data() { return base; }
+    size_t getNumSamples() const { return size; }
+    size_t getSizeInBytes() const { return size * sizeof(float); }
+
+    void clear();
+
+private:
+    juce::HeapBlock<float> block;
+    float* base = nullptr;
+    size_t size = 0;
+};
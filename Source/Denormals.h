@@ -0,0 +1,23 @@
+#pragma once
+#include <juce_core/juce_core.h>
+
+// Denormal protection carried by the recursive state itself. processBlock
+// sets FTZ/DAZ with ScopedNoDenormals, but not every host, thread and CPU
+// honours it, and a tail decaying into the denormal range can cost 10-100x
+// per sample. So every feedback path keeps itself out of that range:
+//
+//  - delay-line loops round their state through JUCE_UNDENORMALISE (combs,
+//    network allpasses) or carry antiDenormalOffset, a DC offset that passes
+//    an allpass unchanged and keeps its memory normal (input diffuser);
+//  - filter states and envelopes are snapped to zero once per block, so a
+//    decaying state spends at most one block in the denormal range.
+namespace Denormals
+{
+    constexpr float antiDenormalOffset = 1.0e-18f; // about -360 dBFS
+    constexpr float snapThreshold = 1.0e-8f;       // as juce::dsp::util::snapToZero
+
+    inline float snapToZero(float x) noexcept
+    {
+        return (x < -snapThreshold || x > snapThreshold) ? x : 0.0f;
+    }
+}
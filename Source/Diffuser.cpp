@@ -0,0 +1,233 @@
+#include "Diffuser.h"
+#include "DelayArena.h"
+#include "Denormals.h"
+
+namespace
+{
+    // Delays in samples at 44.1 kHz (2.5 to 10 ms), all prime, as pairs of an
+    // outer delay and the shorter one nested in it. The first two pairs are
+    // the reduced set; later pairs add density.
+    constexpr int leftTunings[] = { 379, 151, 277, 113, 331, 199, 431, 233 };
+    constexpr int rightTunings[] = { 389, 157, 281, 109, 337, 193, 421, 239 };
+
+    // Nested section output is computed this many samples at a time
+    constexpr int nestedChunk = 256;
+
+    // Allpass coefficient at full diffusion
+    constexpr float maxGain = 0.7f;
+
+    static_assert(std::size(leftTunings) == Diffuser::maxSections && std::size(rightTunings) == Diffuser::maxSections,
+                  "one tuning per section");
+    static_assert(Diffuser::maxSections % 2 == 0, "sections run in nested pairs");
+
+    bool isPrime(int n)
+    {
+        if (n < 2) return false;
+        for (int d = 2; d * d <= n; ++d)
+            if (n % d == 0) return false;
+        return true;
+    }
+
+    // Scales the tuning to the sample rate, then steps up to a prime not used yet
+    int primeDelay(int tuning, double sampleRate, const juce::Array<int>& used)
+    {
+        int n = juce::jmax(2, juce::roundToInt(tuning * sampleRate / 44100.0));
+        while (! isPrime(n) || used.contains(n))
+            ++n;
+        return n;
+    }
+}
+
+void Diffuser::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    numChannels = juce::jlimit(1, maxChannels, (int)spec.numChannels);
+    memorySize = 0;
+    juce::Array<int> used;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const int* tunings = ch == 0 ? leftTunings : rightTunings;
+
+        for (int i = 0; i < maxSections; ++i)
+        {
+            const int size = primeDelay(tunings[i], spec.sampleRate, used);
+            used.add(size);
+            sections[ch][i] = { nullptr, size, 0 };
+            memorySize += DelayArena::alignedSize((size_t)size);
+        }
+    }
+
+    memory = nullptr;
+    switchBuffer.setSize(numChannels, (int)spec.maximumBlockSize);
+    switchLength = juce::jmax(1, juce::roundToInt(switchFadeSeconds * spec.sampleRate));
+    switching = false;
+}
+
+size_t Diffuser::getRequiredStorage() const
+{
+    return memorySize;
+}
+
+void Diffuser::setStorage(float* storage)
+{
+    memory = storage;
+    float* next = memory;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (auto& section : sections[ch])
+        {
+            section.buffer = next;
+            next += DelayArena::alignedSize((size_t)section.size);
+        }
+
+    reset();
+}
+
+void Diffuser::reset()
+{
+    if (memory != nullptr)
+        juce::FloatVectorOperations::clear(memory, (int)memorySize);
+
+    for (auto& channel : sections)
+        for (auto& section : channel)
+            section.index = 0;
+
+    switching = false;
+}
+
+void Diffuser::setNumSections(int newNumSections)
+{
+    newNumSections = juce::jlimit(2, maxSections, (newNumSections + 1) & ~1);
+    if (newNumSections == numSections)
+        return;
+
+    if (memory != nullptr)
+    {
+        // Sections that have not been running hold stale audio
+        const int running = switching ? juce::jmax(previousSections, numSections) : numSections;
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = running; i < newNumSections; ++i)
+            {
+                juce::FloatVectorOperations::clear(sections[ch][i].buffer, sections[ch][i].size);
+                sections[ch][i].index = 0;
+            }
+
+        previousSections = numSections;
+        switchPos = 0;
+        switching = true;
+    }
+
+    numSections = newNumSections;
+}
+
+void Diffuser::setDiffusion(float amount)
+{
+    gain = maxGain * juce::jlimit(0.0f, 1.0f, amount);
+}
+
+void Diffuser::process(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int numSamples = (int)block.getNumSamples();
+    const int channels = juce::jmin(numChannels, (int)block.getNumChannels());
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* samples = block.getChannelPointer((size_t)ch);
+
+        // Passes every section unchanged and keeps their memory out of the
+        // denormal range as the input falls silent
+        juce::FloatVectorOperations::add(samples, Denormals::antiDenormalOffset, numSamples);
+
+        if (switching)
+            processSwitching(samples, switchBuffer.getWritePointer(ch), numSamples, ch);
+        else
+            for (int i = 0; i < numSections; i += 2)
+                processNested(sections[ch][i], sections[ch][i + 1], samples, numSamples, gain);
+    }
+
+    if (switching && (switchPos += numSamples) >= switchLength)
+        switching = false;
+}
+
+void Diffuser::processSwitching(float* samples, float* shorterChain, int numSamples, int ch) noexcept
+{
+    jassert(numSamples <= switchBuffer.getNumSamples());
+
+    // Both chains share their first sections: run those, keep the shorter
+    // chain's output, then run on to the end of the longer one
+    const int shorter = juce::jmin(previousSections, numSections);
+    const int longer = juce::jmax(previousSections, numSections);
+
+    for (int i = 0; i < shorter; i += 2)
+        processNested(sections[ch][i], sections[ch][i + 1], samples, numSamples, gain);
+
+    juce::FloatVectorOperations::copy(shorterChain, samples, numSamples);
+
+    for (int i = shorter; i < longer; i += 2)
+        processNested(sections[ch][i], sections[ch][i + 1], samples, numSamples, gain);
+
+    // Weight of the longer chain: rising when sections were added
+    const bool growing = numSections > previousSections;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float t = juce::jmin(1.0f, (float)(switchPos + i) / (float)switchLength);
+        const float w = growing ? t : 1.0f - t;
+        samples[i] = shorterChain[i] + w * (samples[i] - shorterChain[i]);
+    }
+}
+
+void Diffuser::Section::process(float* samples, int numSamples, float g) noexcept
+{
+    // w[n] = x[n] + g * w[n - size], y[n] = w[n - size] - g * w[n]
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int run = juce::jmin(numSamples - pos, size - index); // Up to the wrap point
+        float* x = samples + pos;
+        float* delayed = buffer + index;
+
+        for (int i = 0; i < run; ++i)
+        {
+            const float old = delayed[i];
+            const float w = x[i] + g * old;
+            delayed[i] = w;
+            x[i] = old - g * w;
+        }
+
+        pos += run;
+        index += run;
+        if (index == size)
+            index = 0;
+    }
+}
+
+void Diffuser::processNested(Section& outer, Section& inner, float* samples, int numSamples, float g) noexcept
+{
+    // As Section::process, with the outer delay's output v passed through the
+    // inner allpass: u = inner(v), w[n] = x[n] + g * u[n], y[n] = u[n] - g * w[n].
+    // Replacing the delay by delay * allpass keeps the whole pair allpass.
+    float nested[nestedChunk];
+
+    for (int pos = 0; pos < numSamples;)
+    {
+        const int run = juce::jmin(numSamples - pos, outer.size - outer.index, nestedChunk);
+        float* x = samples + pos;
+        float* delayed = outer.buffer + outer.index;
+
+        juce::FloatVectorOperations::copy(nested, delayed, run);
+        inner.process(nested, run, g);
+
+        for (int i = 0; i < run; ++i)
+        {
+            const float u = nested[i];
+            const float w = x[i] + g * u;
+            delayed[i] = w;
+            x[i] = u - g * w;
+        }
+
+        pos += run;
+        outer.index += run;
+        if (outer.index == outer.size)
+            outer.index = 0;
+    }
+}
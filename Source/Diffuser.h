@@ -0,0 +1,68 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+// Input diffuser: a series of nested Schroeder allpasses per channel in front
+// of the network, smearing transients into a dense attack before the combs
+// see them. Sections run in pairs: the second sits inside the first's delay
+// loop, so each pass through the outer delay is diffused again and the echo
+// density grows much faster than with the same sections in series. Delays are
+// distinct primes at every sample rate, so no two sections share a period,
+// and L and R use different sets for decorrelation.
+//
+// Each section runs over the block in runs no longer than its delay. Within a
+// run every read is at least one full delay old, so the loop carries no
+// sample-to-sample dependency and vectorises over time. The nested section
+// only ever sees the outer delay's output, which is known for the whole run.
+//
+// The delay memory lives in the owner's DelayArena, like the other delay lines.
+class Diffuser
+{
+public:
+    static constexpr int maxSections = 8;
+    static constexpr int maxChannels = 2;
+    static constexpr double switchFadeSeconds = 0.02;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    size_t getRequiredStorage() const;
+    void setStorage(float* storage);
+    void reset();
+
+    // 2..maxSections, in nested pairs (an odd count rounds up). Crossfades
+    // from the old chain to the new one over switchFadeSeconds; sections
+    // coming into use start empty.
+    void setNumSections(int newNumSections);
+    void setDiffusion(float amount);         // 0..1; 0 passes the input through untouched
+
+    bool isActive() const { return gain > 0.0f; }
+
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept;
+
+private:
+    struct Section
+    {
+        float* buffer = nullptr;
+        int size = 0;
+        int index = 0;
+
+        void process(float* samples, int numSamples, float g) noexcept;
+    };
+
+    // Runs outer with inner nested in its delay loop
+    static void processNested(Section& outer, Section& inner, float* samples, int numSamples, float g) noexcept;
+
+    void processSwitching(float* samples, float* shorterChain, int numSamples, int ch) noexcept;
+
+    Section sections[maxChannels][maxSections];
+    float* memory = nullptr;
+    size_t memorySize = 0;
+    int numChannels = 0;
+    int numSections = maxSections;
+    float gain = 0.0f;
+
+    // Section count change in progress: both chains run and are crossfaded
+    juce::AudioBuffer<float> switchBuffer; // output of the shorter chain
+    int previousSections = maxSections;
+    int switchLength = 0;
+    int switchPos = 0;
+    bool switching = false;
+};
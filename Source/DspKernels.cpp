@@ -0,0 +1,25 @@
+#include "DspKernels.h"
+#include <juce_core/juce_core.h>
+
+int DspKernels::getAvailable(const DspKernels* (&variants)[maxVariants])
+{
+    int count = 0;
+    variants[count++] = getBaseline();
+
+    if (auto* avx2 = getAvx2(); avx2 != nullptr && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3())
+        variants[count++] = avx2;
+
+    if (auto* avx512 = getAvx512(); avx512 != nullptr && juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512VL())
+        variants[count++] = avx512;
+
+    return count;
+}
+
+const DspKernels& DspKernels::get()
+{
+    static const DspKernels& selected = [] () -> const DspKernels& {
+        const DspKernels* variants[maxVariants] = {};
+        return *variants[getAvailable(variants) - 1];
+    }();
+    return selected;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Data-parallel inner loops, compiled once per instruction set from
+// DspKernelsImpl.h: a baseline build (SSE2 on x86-64, NEON on arm64) plus
+// AVX2 and AVX-512 builds on x86-64. get() picks the widest variant the CPU
+// supports on first use and keeps it for the life of the process.
+//
+// Only loops that vectorise over time live here. The recursive filters,
+// envelopes and the comb network are bound by their feedback, not by
+// vector width.
+//
+// This header includes nothing: the per-ISA files include it while compiled
+// with wider target flags, and any shared inline or template code reaching
+// them could be emitted there as a weak AVX copy that the linker then keeps
+// for the whole binary.
+struct DspKernels
+{
+    const char* name;
+
+    // dest[i] = max(|left[i]|, |right[i]|)
+    void (*linkedPeak)(const float* left, const float* right, float* dest, int numSamples) noexcept;
+
+    // In-place L/R -> (mid * midGain, side * sideGain) -> L/R
+    void (*midSide)(float* left, float* right, int numSamples, float midGain, float sideGain) noexcept;
+
+    // out[i] = out[i] * dryGain + wet[i] * wetGain
+    void (*mix)(float* out, const float* wet, float dryGain, float wetGain, int numSamples) noexcept;
+
+    // Dot product of two 16-float arrays (one halfband resampler phase)
+    float (*dot16)(const float* a, const float* b) noexcept;
+
+    static const DspKernels& get();
+
+    // Fills variants with every variant this CPU can run, baseline first, and
+    // returns how many. For tests and benchmarks.
+    static constexpr int maxVariants = 3;
+    static int getAvailable(const DspKernels* (&variants)[maxVariants]);
+
+private:
+    // Defined in DspKernels_<isa>.cpp; nullptr when that file was built
+    // without its instruction set enabled (e.g. on arm64).
+    static const DspKernels* getBaseline();
+    static const DspKernels* getAvx2();
+    static const DspKernels* getAvx512();
+};
@@ -0,0 +1,53 @@
+// Kernel bodies for DspKernels. Not a normal header: each DspKernels_<isa>.cpp
+// includes it once, compiled with its own target flags, after defining
+// FDNR_KERNEL_NAMESPACE and FDNR_KERNEL_NAME. The loops are written so the
+// compiler vectorises them at whatever width the flags allow.
+//
+// No standard or JUCE headers: only file-local helpers, so nothing compiled
+// here with AVX flags can stand in for a shared inline function elsewhere
+// (see DspKernels.h). The files are also built with floating-point
+// contraction off, so every variant rounds like the baseline.
+
+namespace FDNR_KERNEL_NAMESPACE
+{
+    static inline float magnitude(float x) noexcept { return x < 0.0f ? -x : x; }
+    static inline float larger(float a, float b) noexcept { return a < b ? b : a; }
+
+    void linkedPeak(const float* left, const float* right, float* dest, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = larger(magnitude(left[i]), magnitude(right[i]));
+    }
+
+    void midSide(float* left, float* right, int numSamples, float midGain, float sideGain) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float m = (left[i] + right[i]) * 0.5f * midGain;
+            const float s = (left[i] - right[i]) * 0.5f * sideGain;
+            left[i] = m + s;
+            right[i] = m - s;
+        }
+    }
+
+    void mix(float* out, const float* wet, float dryGain, float wetGain, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = out[i] * dryGain + wet[i] * wetGain;
+    }
+
+    float dot16(const float* a, const float* b) noexcept
+    {
+        // Eight independent accumulators fill one AVX register (or two SSE/NEON
+        // ones) without needing -ffast-math to reorder a single float sum.
+        float lanes[8] = {};
+
+        for (int i = 0; i < 16; i += 8)
+            for (int l = 0; l < 8; ++l)
+                lanes[l] += a[i + l] * b[i + l];
+
+        return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+    }
+
+    const DspKernels kernels { FDNR_KERNEL_NAME, linkedPeak, midSide, mix, dot16 };
+}
@@ -0,0 +1,18 @@
+#include "DspKernels.h"
+
+// Built with -mavx2 -mfma (/arch:AVX2) on x86-64, see CMakeLists.txt
+#if defined(__AVX2__)
+ #define FDNR_KERNEL_NAME "AVX2"
+ #define FDNR_KERNEL_NAMESPACE Avx2Kernels
+ #include "DspKernelsImpl.h"
+
+const DspKernels* DspKernels::getAvx2()
+{
+    return &Avx2Kernels::kernels;
+}
+#else
+const DspKernels* DspKernels::getAvx2()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,18 @@
+#include "DspKernels.h"
+
+// Built with -mavx512f -mavx512vl -mfma (/arch:AVX512) on x86-64, see CMakeLists.txt
+#if defined(__AVX512F__)
+ #define FDNR_KERNEL_NAME "AVX-512"
+ #define FDNR_KERNEL_NAMESPACE Avx512Kernels
+ #include "DspKernelsImpl.h"
+
+const DspKernels* DspKernels::getAvx512()
+{
+    return &Avx512Kernels::kernels;
+}
+#else
+const DspKernels* DspKernels::getAvx512()
+{
+    return nullptr;
+}
+#endif
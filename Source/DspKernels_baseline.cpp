@@ -0,0 +1,15 @@
+#include "DspKernels.h"
+
+// No extra target flags: SSE2 on x86-64 and NEON on arm64 are part of the base ABI.
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+ #define FDNR_KERNEL_NAME "NEON"
+#else
+ #define FDNR_KERNEL_NAME "SSE2"
+#endif
+#define FDNR_KERNEL_NAMESPACE BaselineKernels
+#include "DspKernelsImpl.h"
+
+const DspKernels* DspKernels::getBaseline()
+{
+    return &BaselineKernels::kernels;
+}
@@ -0,0 +1,61 @@
+#include "EnvelopeFollower.h"
+#include "DspKernels.h"
+#include "Denormals.h"
+
+void EnvelopeFollower::prepare(float attackCoefficient, float releaseCoefficient)
+{
+    attackCoeff = attackCoefficient;
+    releaseCoeff = releaseCoefficient;
+    reset();
+}
+
+void EnvelopeFollower::reset()
+{
+    envelope = 0.0f;
+}
+
+void EnvelopeFollower::computeDetector(const juce::dsp::AudioBlock<const float>& source, Detector mode, float* dest, size_t numSamples)
+{
+    const int n = (int)numSamples;
+
+    if (source.getNumChannels() == 0)
+    {
+        juce::FloatVectorOperations::clear(dest, n);
+        return;
+    }
+
+    const float* left = source.getChannelPointer(0);
+
+    if (source.getNumChannels() == 1)
+    {
+        juce::FloatVectorOperations::abs(dest, left, n);
+        return;
+    }
+
+    const float* right = source.getChannelPointer(1);
+
+    if (mode == Detector::mid)
+    {
+        juce::FloatVectorOperations::add(dest, left, right, n);
+        juce::FloatVectorOperations::abs(dest, dest, n);
+        juce::FloatVectorOperations::multiply(dest, 0.5f, n);
+    }
+    else
+    {
+        DspKernels::get().linkedPeak(left, right, dest, n);
+    }
+}
+
+void EnvelopeFollower::process(float* detectorInOut, size_t numSamples)
+{
+    float env = envelope;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        const float in = detectorInOut[i];
+        env += (in - env) * (in > env ? attackCoeff : releaseCoeff);
+        detectorInOut[i] = env;
+    }
+
+    envelope = Denormals::snapToZero(env); // Released to silence, it would otherwise settle on a denormal
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+// Block-based peak follower used by the ducking and dynamic EQ detectors.
+// The detector signal is built once per block (stereo-linked), then the
+// attack/release recursion runs over it in a single tight loop.
+class EnvelopeFollower
+{
+public:
+    enum class Detector
+    {
+        linkedPeak = 0, // max(|L|, |R|)
+        mid             // |L + R| / 2
+    };
+
+    // One-pole coefficients, 1 - exp(-1 / (seconds * fs)); see RateTables
+    void prepare(float attackCoefficient, float releaseCoefficient);
+    void reset();
+
+    // Writes the rectified, stereo-linked detector signal of source into dest.
+    static void computeDetector(const juce::dsp::AudioBlock<const float>& source, Detector mode, float* dest, size_t numSamples);
+
+    // Runs the follower over a detector signal, writing the envelope in place.
+    void process(float* detectorInOut, size_t numSamples);
+
+    float getCurrentValue() const { return envelope; }
+
+private:
+    float attackCoeff = 1.0f;
+    float releaseCoeff = 1.0f;
+    float envelope = 0.0f;
+};
@@ -0,0 +1,181 @@
+#include "HalfbandResampler.h"
+#include <cmath>
+
+namespace
+{
+    // Nonzero off-centre taps of a 31-tap Blackman-windowed halfband lowpass
+    // (centre tap 0.5), normalised for unity gain at DC. About 70 dB of
+    // stopband rejection, passband flat to roughly 0.16 of the input rate.
+    struct HalfbandCoefficients
+    {
+        static constexpr int numTaps = 16;
+        alignas(16) float taps[numTaps];
+
+        HalfbandCoefficients()
+        {
+            const int length = 2 * numTaps - 1;
+            const int centre = numTaps - 1;
+            const double pi = juce::MathConstants<double>::pi;
+            double sum = 0.0;
+
+            for (int i = 0; i < numTaps; ++i)
+            {
+                const int n = 2 * i;
+                const int offset = n - centre; // always odd
+                const double x = (n + 1.0) / (length + 1.0); // window endpoints fall outside the taps
+                const double window = 0.42 - 0.5 * std::cos(2.0 * pi * x) + 0.08 * std::cos(4.0 * pi * x);
+                const double value = window * std::sin(pi * offset / 2.0) / (pi * offset);
+
+                taps[i] = (float)value;
+                sum += value;
+            }
+
+            for (auto& tap : taps)
+                tap = (float)(tap * 0.5 / sum);
+        }
+    };
+
+    const HalfbandCoefficients halfband;
+    static_assert(HalfbandCoefficients::numTaps == 16, "one phase is a DspKernels::dot16");
+}
+
+void HalfbandResampler::prepare(int maximumBlockSize)
+{
+    // Every stage can carry one sample in, so allow for that on top of the ratio
+    stageBuffers[0].setSize(maxChannels, maximumBlockSize / 2 + 2);
+    stageBuffers[1].setSize(maxChannels, maximumBlockSize / 4 + 2);
+    upBuffer.setSize(maxChannels, maximumBlockSize + maxFactor);
+
+    reset();
+}
+
+void HalfbandResampler::setFactor(int newFactor)
+{
+    factor = toFactor(newFactor);
+    numStages = factor == 4 ? 2 : (factor == 2 ? 1 : 0);
+    reset();
+}
+
+void HalfbandResampler::reset()
+{
+    for (int s = 0; s < maxStages; ++s)
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            decimators[s][ch] = {};
+            interpolators[s][ch].input.clear();
+        }
+
+    // factor - 1 samples of silence keep the output side one group ahead, so
+    // a block never needs more interpolated samples than it has produced.
+    upBuffer.clear();
+    pendingOutput = factor - 1;
+}
+
+int HalfbandResampler::getLatencyInSamples() const
+{
+    // Each stage delays by (phaseTaps - 1) samples at its input rate on the
+    // way down and again on the way up. The silence primed in reset() only
+    // makes up for waiting on a full group of input samples.
+    int latency = 0;
+    for (int s = 0; s < numStages; ++s)
+        latency += (2 * (phaseTaps - 1)) << s;
+
+    return latency;
+}
+
+float* HalfbandResampler::getReducedChannel(int channel) noexcept
+{
+    jassert(numStages > 0);
+    return stageBuffers[numStages - 1].getWritePointer(channel);
+}
+
+int HalfbandResampler::downsample(const juce::dsp::AudioBlock<float>& block, int numChannels) noexcept
+{
+    const int numSamples = (int)block.getNumSamples();
+    int numReduced = numSamples;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* in = block.getChannelPointer((size_t)ch);
+        numReduced = numSamples;
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            float* out = stageBuffers[s].getWritePointer(ch);
+            numReduced = decimators[s][ch].process(in, numReduced, out, dotProduct);
+            in = out;
+        }
+    }
+
+    return numReduced;
+}
+
+void HalfbandResampler::upsample(const juce::dsp::AudioBlock<float>& block, int numChannels, int numReduced) noexcept
+{
+    const int numSamples = (int)block.getNumSamples();
+    int available = pendingOutput;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        const float* in = getReducedChannel(ch);
+        int n = numReduced;
+
+        for (int s = numStages - 1; s > 0; --s)
+        {
+            float* out = stageBuffers[s - 1].getWritePointer(ch);
+            interpolators[s][ch].process(in, n, out, dotProduct);
+            in = out;
+            n *= 2;
+        }
+
+        float* up = upBuffer.getWritePointer(ch);
+        interpolators[0][ch].process(in, n, up + pendingOutput, dotProduct);
+        available = pendingOutput + 2 * n;
+        jassert(available >= numSamples);
+
+        juce::FloatVectorOperations::copy(block.getChannelPointer((size_t)ch), up, numSamples);
+
+        // Keep the surplus (at most factor - 1 samples) for the next block
+        for (int i = numSamples; i < available; ++i)
+            up[i - numSamples] = up[i];
+    }
+
+    pendingOutput = available - numSamples;
+}
+
+int HalfbandResampler::Decimator::process(const float* in, int numSamples, float* out, DotProduct dot) noexcept
+{
+    int numOut = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (! hasPending)
+        {
+            pendingEven = in[i];
+            hasPending = true;
+            continue;
+        }
+
+        // Odd phase through the 16 nonzero taps, even phase only hits the centre tap
+        even.push(pendingEven);
+        odd.push(in[i]);
+        hasPending = false;
+
+        out[numOut++] = dot(halfband.taps, odd.window()) + 0.5f * even.window()[halfLength - 1];
+    }
+
+    return numOut;
+}
+
+void HalfbandResampler::Interpolator::process(const float* in, int numSamples, float* out, DotProduct dot) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        input.push(in[i]);
+        const float* window = input.window();
+
+        // Zero-stuffed input: one phase sees the 16 taps, the other only the centre
+        out[2 * i] = 2.0f * dot(halfband.taps, window);
+        out[2 * i + 1] = window[halfLength - 1];
+    }
+}
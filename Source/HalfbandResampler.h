@@ -0,0 +1,97 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "DspKernels.h"
+
+// Streaming 2x / 4x decimator and interpolator built from cascaded 31-tap
+// halfband FIR stages, for running a processor at a fraction of the host rate.
+//
+// Each stage is polyphase: half the halfband taps are zero, so a decimator
+// only filters the odd input phase (a 16-tap dot product) and delays the even
+// one, and an interpolator computes one 16-tap output per input and copies
+// the other. Block lengths need not be multiples of the factor; the odd
+// samples are carried to the next block.
+//
+//     int numReduced = resampler.downsample(block, numChannels);
+//     ... process resampler.getReducedChannel(ch)[0 .. numReduced) ...
+//     resampler.upsample(block, numChannels, numReduced);
+class HalfbandResampler
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int maxFactor = 4;
+
+    void prepare(int maximumBlockSize);
+    void setFactor(int newFactor); // 1, 2 or 4; resets the filter state
+    static int toFactor(int requested) { return requested >= 4 ? 4 : (requested >= 2 ? 2 : 1); } // what setFactor picks
+    void reset();
+
+    int getFactor() const { return factor; }
+
+    // Round trip (down, then up) delay at the host rate.
+    int getLatencyInSamples() const;
+
+    // Filters and decimates the block into the reduced-rate buffers and
+    // returns how many reduced-rate samples were produced.
+    int downsample(const juce::dsp::AudioBlock<float>& block, int numChannels) noexcept;
+
+    // Interpolates numReduced samples from the reduced-rate buffers back into
+    // every sample of the block.
+    void upsample(const juce::dsp::AudioBlock<float>& block, int numChannels, int numReduced) noexcept;
+
+    float* getReducedChannel(int channel) noexcept;
+
+private:
+    static constexpr int halfLength = 8;           // coefficient pairs either side of centre
+    static constexpr int phaseTaps = 2 * halfLength; // nonzero taps in the filtered phase
+    static constexpr int maxStages = 2;
+
+    // One 16-tap phase: DspKernels::dot16, picked for this CPU
+    using DotProduct = float (*)(const float* taps, const float* window) noexcept;
+
+    // Newest-first history, stored twice so any window of phaseTaps samples
+    // is contiguous for the dot product.
+    struct History
+    {
+        float data[2 * phaseTaps] = {};
+        int pos = 0;
+
+        void push(float value) noexcept
+        {
+            pos = (pos == 0 ? phaseTaps : pos) - 1;
+            data[pos] = data[pos + phaseTaps] = value;
+        }
+
+        const float* window() const noexcept { return data + pos; } // [i] = pushed i samples ago
+        void clear() noexcept { *this = {}; }
+    };
+
+    struct Decimator
+    {
+        History odd, even;
+        float pendingEven = 0.0f;
+        bool hasPending = false;
+
+        int process(const float* in, int numSamples, float* out, DotProduct dot) noexcept;
+    };
+
+    struct Interpolator
+    {
+        History input;
+
+        void process(const float* in, int numSamples, float* out, DotProduct dot) noexcept; // writes 2 * numSamples
+    };
+
+    const DotProduct dotProduct = DspKernels::get().dot16;
+
+    int factor = 1;
+    int numStages = 0;
+
+    Decimator decimators[maxStages][maxChannels];
+    Interpolator interpolators[maxStages][maxChannels];
+
+    // Rate buffers: [0] = half rate, [1] = quarter rate. upBuffer holds the
+    // host-rate output, starting with the samples left over from the last block.
+    juce::AudioBuffer<float> stageBuffers[maxStages];
+    juce::AudioBuffer<float> upBuffer;
+    int pendingOutput = 0;
+};
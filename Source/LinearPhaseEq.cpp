@@ -0,0 +1,171 @@
+#include "LinearPhaseEq.h"
+#include <cmath>
+#include <complex>
+
+namespace
+{
+    constexpr int idlePollMs = 20;
+
+    double sectionMagnitude(const std::array<float, 6>& c, double omega)
+    {
+        const std::complex<double> z1 = std::polar(1.0, -omega);
+        const std::complex<double> z2 = z1 * z1;
+        const auto numerator = (double)c[0] + (double)c[1] * z1 + (double)c[2] * z2;
+        const auto denominator = (double)c[3] + (double)c[4] * z1 + (double)c[5] * z2;
+        return std::abs(numerator / denominator);
+    }
+}
+
+bool Eq3Settings::operator==(const Eq3Settings& other) const noexcept
+{
+    return lowGainDb == other.lowGainDb && midGainDb == other.midGainDb && highGainDb == other.highGainDb
+        && lowFreq == other.lowFreq && midFreq == other.midFreq && midQ == other.midQ && highFreq == other.highFreq;
+}
+
+std::array<std::array<float, 6>, 3> Eq3Settings::makeSections(double sampleRate) const
+{
+    using Coefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+    const float maxFreq = (float)sampleRate * 0.45f;
+
+    return { Coefficients::makeLowShelf(sampleRate, juce::jmin(lowFreq, maxFreq), 0.71f, juce::Decibels::decibelsToGain(lowGainDb)),
+             Coefficients::makePeakFilter(sampleRate, juce::jmin(midFreq, maxFreq), midQ, juce::Decibels::decibelsToGain(midGainDb)),
+             Coefficients::makeHighShelf(sampleRate, juce::jmin(highFreq, maxFreq), 0.71f, juce::Decibels::decibelsToGain(highGainDb)) };
+}
+
+LinearPhaseEq::~LinearPhaseEq()
+{
+    designThread->removeTimeSliceClient(this);
+}
+
+void LinearPhaseEq::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    // Nothing may be designed while the convolution is re-prepared
+    designThread->removeTimeSliceClient(this);
+
+    sampleRate = spec.sampleRate;
+    firLength = juce::nextPowerOfTwo((int)(sampleRate / 12.0)); // 4096 taps at 44.1/48 kHz
+    convolution.prepare(spec);
+
+    // A new engine needs a full FIR of input, and the switch to it crossfades
+    settleSamples = firLength + (int)(0.1 * sampleRate);
+    samplesSinceLoad = 0;
+    firSettled = false;
+    fallbackDelay.prepare(spec, getLatencyInSamples());
+    fallbackDelay.setDelay(getLatencyInSamples());
+    fallbackBuffer.setSize((int)spec.numChannels, (int)spec.maximumBlockSize);
+
+    hasPending = false;
+    hasRequested = false;
+
+    designThread->addTimeSliceClient(this);
+}
+
+void LinearPhaseEq::reset()
+{
+    convolution.reset();
+    fallbackDelay.reset();
+
+    // With its history gone the convolution needs a full FIR of input again
+    samplesSinceLoad = 0;
+    firSettled = false;
+}
+
+void LinearPhaseEq::setSettings(const Eq3Settings& settings) noexcept
+{
+    if (hasRequested && settings == requested)
+        return;
+
+    // Never wait on the designer; if it holds the lock, retry next block
+    const juce::SpinLock::ScopedTryLockType lock(pendingLock);
+    if (! lock.isLocked())
+        return;
+
+    pending = settings;
+    hasPending = true;
+    requested = settings;
+    hasRequested = true;
+}
+
+void LinearPhaseEq::process(const juce::dsp::ProcessContextReplacing<float>& context) noexcept
+{
+    if (firSettled)
+    {
+        convolution.process(context);
+        return;
+    }
+
+    // The convolution still runs so it has history when it takes over; the
+    // output meanwhile is the plain delay, which matches it for a flat EQ
+    auto& block = context.getOutputBlock();
+    const size_t numSamples = block.getNumSamples();
+    auto fallbackBlock = juce::dsp::AudioBlock<float>(fallbackBuffer).getSubBlock(0, numSamples)
+                             .getSubsetChannelBlock(0, block.getNumChannels());
+
+    fallbackBlock.copyFrom(block);
+    fallbackDelay.process(fallbackBlock);
+    convolution.process(context);
+    block.copyFrom(fallbackBlock);
+
+    if (convolution.getCurrentIRSize() == firLength)
+    {
+        samplesSinceLoad += (int)numSamples;
+        firSettled = samplesSinceLoad >= settleSamples;
+    }
+}
+
+int LinearPhaseEq::useTimeSlice()
+{
+    Eq3Settings settings;
+
+    {
+        const juce::SpinLock::ScopedLockType lock(pendingLock);
+        if (! hasPending)
+            return idlePollMs;
+
+        settings = pending;
+        hasPending = false;
+    }
+
+    design(settings);
+    return 0; // Check again straight away in case the settings moved on
+}
+
+void LinearPhaseEq::design(const Eq3Settings& settings)
+{
+    // Zero-phase magnitude response on the FFT grid
+    const int order = juce::roundToInt(std::log2((double)firLength));
+    juce::dsp::FFT fft(order);
+    std::vector<float> spectrum((size_t)firLength * 2, 0.0f);
+
+    const auto sections = settings.makeSections(sampleRate);
+    const double binToOmega = juce::MathConstants<double>::twoPi / firLength;
+
+    for (int k = 0; k <= firLength / 2; ++k)
+    {
+        double magnitude = 1.0;
+        for (auto& section : sections)
+            magnitude *= sectionMagnitude(section, k * binToOmega);
+
+        spectrum[(size_t)(2 * k)] = (float)magnitude;
+    }
+
+    fft.performRealOnlyInverseTransform(spectrum.data());
+
+    // Centre the impulse at firLength / 2 and window it. Tap 0 stays zero so
+    // the FIR is symmetric about its centre.
+    juce::AudioBuffer<float> fir(1, firLength);
+    float* taps = fir.getWritePointer(0);
+    const int centre = firLength / 2;
+
+    for (int n = 0; n < firLength; ++n)
+        taps[n] = spectrum[(size_t)((n + centre) % firLength)];
+
+    std::vector<float> window((size_t)firLength - 1);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(),
+                                                             juce::dsp::WindowingFunction<float>::blackman, false);
+    taps[0] = 0.0f;
+    juce::FloatVectorOperations::multiply(taps + 1, window.data(), firLength - 1);
+
+    convolution.loadImpulseResponse(std::move(fir), sampleRate, juce::dsp::Convolution::Stereo::no,
+                                    juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "CompensationDelay.h"
+
+// Band layout of the 3-band wet EQ: low shelf, mid peak, high shelf.
+struct Eq3Settings
+{
+    float lowGainDb = 0.0f;
+    float midGainDb = 0.0f;
+    float highGainDb = 0.0f;
+    float lowFreq = 200.0f;
+    float midFreq = 1000.0f;
+    float midQ = 1.0f;
+    float highFreq = 6000.0f;
+
+    bool operator==(const Eq3Settings& other) const noexcept;
+    bool operator!=(const Eq3Settings& other) const noexcept { return ! operator==(other); }
+
+    // Raw { b0, b1, b2, a0, a1, a2 } per band, as IIR::ArrayCoefficients
+    // returns them. Band frequencies are kept below Nyquist.
+    std::array<std::array<float, 6>, 3> makeSections(double sampleRate) const;
+};
+
+// Linear-phase version of the 3-band EQ: the combined magnitude response of
+// the three bands as one symmetric FIR, run through juce::dsp::Convolution
+// (uniform partitioned FFT convolution, which crossfades when the response is
+// replaced). The FIR is redesigned on a shared background thread whenever
+// the settings change, so the audio thread only posts the new settings.
+//
+// The FIR is about 85 ms long, and its centre delays the signal by
+// getLatencyInSamples(). The delay holds from the first block: until a
+// designed FIR has loaded and filled (the convolution starts out as a
+// pass-through), the output is the input delayed by the same amount.
+//
+// That fallback delay lives in the owner's DelayArena, like the other delay lines.
+class LinearPhaseEq : private juce::TimeSliceClient
+{
+public:
+    LinearPhaseEq() = default;
+    ~LinearPhaseEq() override;
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    size_t getRequiredStorage() const { return fallbackDelay.getRequiredStorage(); }
+    void setStorage(float* storage) { fallbackDelay.setStorage(storage); }
+    void reset();
+
+    // Audio thread. Queues a redesign when the settings differ from the last
+    // ones queued; the current response plays until the new one is loaded.
+    void setSettings(const Eq3Settings& settings) noexcept;
+
+    void process(const juce::dsp::ProcessContextReplacing<float>& context) noexcept;
+
+    int getLatencyInSamples() const { return firLength / 2; }
+
+private:
+    struct DesignThread : juce::TimeSliceThread
+    {
+        DesignThread() : juce::TimeSliceThread("EQ designer") { startThread(juce::Thread::Priority::low); }
+        ~DesignThread() override { stopThread(1000); }
+    };
+
+    int useTimeSlice() override;
+    void design(const Eq3Settings& settings);
+
+    // One loader queue (and thread) for every instance, instead of the one a
+    // default-constructed Convolution starts for itself
+    juce::SharedResourcePointer<juce::dsp::ConvolutionMessageQueue> loadQueue;
+    juce::dsp::Convolution convolution { juce::dsp::Convolution::Latency { 0 }, *loadQueue };
+    juce::SharedResourcePointer<DesignThread> designThread;
+
+    double sampleRate = 44100.0;
+    int firLength = 4096;
+
+    // Fallback until the convolution carries a designed FIR with full history
+    CompensationDelay fallbackDelay;
+    juce::AudioBuffer<float> fallbackBuffer;
+    int settleSamples = 0;
+    int samplesSinceLoad = 0;
+    bool firSettled = false;
+
+    // Settings handed from the audio thread to the designer
+    juce::SpinLock pendingLock;
+    Eq3Settings pending;
+    bool hasPending = false;
+
+    Eq3Settings requested; // audio thread only
+    bool hasRequested = false;
+};
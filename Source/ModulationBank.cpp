@@ -0,0 +1,158 @@
+#include "ModulationBank.h"
+#include <cmath>
+
+namespace
+{
+    // Deterministic -1..1 value for (cycle, voice)
+    float hashToUnit(juce::int64 cycle, int voice) noexcept
+    {
+        auto x = (juce::uint64)cycle * 0x9E3779B97F4A7C15ull + (juce::uint64)voice * 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 31;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 29;
+        return (float)(x >> 40) / (float)(1 << 23) - 1.0f;
+    }
+
+    // Timeline jumps smaller than this are tempo rounding, not a locate
+    constexpr double jumpToleranceCycles = 1.0e-3;
+
+    // Fractional phase offset of each voice (golden-ratio spacing)
+    double voicePhase(int voice) noexcept
+    {
+        const double scaled = voice * 0.6180339887498949;
+        return scaled - std::floor(scaled);
+    }
+}
+
+void ModulationBank::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    shapes = SharedTables::getShapes(); // Built here rather than on the audio thread
+    reset();
+}
+
+void ModulationBank::reset()
+{
+    freeRunSeconds = 0.0;
+    block = {};
+    blockLengthSeconds = 0.0;
+    hasBlock = false;
+    fading = false;
+    clock = requested;
+    phaseOffset = 0.0;
+}
+
+void ModulationBank::setRate(float hz)
+{
+    requested.rateHz = juce::jmax(0.0f, hz);
+}
+
+void ModulationBank::setTempoSync(double newBeatsPerCycle, double bpm)
+{
+    requested.beatsPerCycle = newBeatsPerCycle;
+    requested.beatsPerSecond = juce::jmax(1.0, bpm) / 60.0;
+}
+
+void ModulationBank::setRandomness(float amount)
+{
+    randomness = juce::jlimit(0.0f, 1.0f, amount);
+}
+
+void ModulationBank::beginBlock(juce::int64 hostSamples, double ppq, int numSamples)
+{
+    // Where the previous block's timeline carries on
+    const Position continued = advance(block, blockLengthSeconds);
+
+    if (hostSamples >= 0)
+        freeRunSeconds = (double)hostSamples / sampleRate; // Follow the host; continue from here if it stops
+
+    const Position next { freeRunSeconds, ppq };
+    freeRunSeconds += numSamples / sampleRate;
+
+    if (fading)
+    {
+        fadeFrom = advance(fadeFrom, blockLengthSeconds);
+        fadeElapsedSeconds += blockLengthSeconds;
+        fading = fadeElapsedSeconds < jumpFadeSeconds;
+    }
+
+    if (hasBlock && std::abs(cyclesAt(next, 0.0, clock) - cyclesAt(continued, 0.0, clock)) > jumpToleranceCycles)
+    {
+        fadeFrom = continued;
+        fadePhaseOffset = phaseOffset;
+        fadeElapsedSeconds = 0.0;
+        fading = true;
+    }
+
+    // A new rate carries on from the phase the old one reached here. The
+    // first block after a reset starts on the timeline's own phase.
+    if (requested != clock)
+    {
+        if (hasBlock)
+        {
+            phaseOffset += cyclesAt(next, 0.0, clock) - cyclesAt(next, 0.0, requested);
+            if (fading)
+                fadePhaseOffset += cyclesAt(fadeFrom, 0.0, clock) - cyclesAt(fadeFrom, 0.0, requested);
+        }
+        clock = requested;
+    }
+
+    block = next;
+    blockLengthSeconds = numSamples / sampleRate;
+    hasBlock = true;
+}
+
+float ModulationBank::getValue(int voice, double offsetSeconds) const noexcept
+{
+    const float value = valueAt(voice, cyclesAt(block, offsetSeconds, clock) + phaseOffset);
+
+    if (! fading)
+        return value;
+
+    const float from = valueAt(voice, cyclesAt(fadeFrom, offsetSeconds, clock) + fadePhaseOffset);
+    const float t = (float)juce::jmin(1.0, (fadeElapsedSeconds + offsetSeconds) / jumpFadeSeconds);
+    return from + t * (value - from);
+}
+
+ModulationBank::Position ModulationBank::advance(const Position& position, double seconds) const noexcept
+{
+    return { position.seconds + seconds, position.beats >= 0.0 ? position.beats + seconds * clock.beatsPerSecond : -1.0 };
+}
+
+double ModulationBank::cyclesAt(const Position& position, double offsetSeconds, const Clock& at) const noexcept
+{
+    if (at.beatsPerCycle > 0.0)
+    {
+        const double beats = position.beats >= 0.0 ? position.beats + offsetSeconds * at.beatsPerSecond
+                                                   : (position.seconds + offsetSeconds) * at.beatsPerSecond;
+        return beats / at.beatsPerCycle;
+    }
+
+    return (position.seconds + offsetSeconds) * at.rateHz;
+}
+
+float ModulationBank::valueAt(int voice, double cycles) const noexcept
+{
+    cycles += voicePhase(voice);
+
+    const double whole = std::floor(cycles);
+    const double phase = cycles - whole;
+
+    float value = 0.0f;
+
+    if (randomness < 1.0f)
+        value += (1.0f - randomness) * shapes->sine.lookup(phase);
+
+    if (randomness > 0.0f)
+    {
+        // Smoothstep between one random point per cycle
+        const auto cycle = (juce::int64)whole;
+        const float t = (float)phase;
+        const float smooth = t * t * (3.0f - 2.0f * t);
+        const float a = hashToUnit(cycle, voice);
+        const float b = hashToUnit(cycle + 1, voice);
+        value += randomness * (a + smooth * (b - a));
+    }
+
+    return value;
+}
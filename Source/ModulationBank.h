@@ -0,0 +1,89 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "SharedTables.h"
+
+// Bank of LFO voices that modulate the reverb network's delay taps. Every
+// value is a pure function of the timeline position: the host's position
+// while the transport runs, or a free-running clock while stopped. Instances
+// playing the same session therefore produce identical modulation, and a
+// bounce renders the same modulation every time.
+//
+// Each voice blends a sine (from a table shared by all instances) with a
+// smoothed random walk, which is value noise hashed from the cycle index.
+// Voices are spread in phase so the delay lines do not move in lockstep.
+//
+// When the timeline jumps (transport start, loop wrap, locate) the voices
+// crossfade over jumpFadeSeconds from where they were heading to the new
+// position, so the swept delay taps glide instead of stepping. Past that
+// fade the modulation is again a function of the position alone.
+//
+// A change of rate, sync value or tempo takes effect at the next beginBlock()
+// and keeps the phase continuous there: the phase offset is rebased so the
+// new rate carries on from the current phase. The modulation is then a
+// function of the position and of the rate changes before it, which
+// automation replays identically.
+class ModulationBank
+{
+public:
+    static constexpr int maxVoices = 24;
+    static constexpr double jumpFadeSeconds = 0.1;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    void setRate(float hz);
+    void setTempoSync(double beatsPerCycle, double bpm); // 0 beats = free rate
+    void setRandomness(float amount);                    // 0 = pure sine, 1 = pure random walk
+
+    // Fixes the timeline position of the block about to run. hostSamples and
+    // ppq are negative when the host does not provide them (or is stopped).
+    void beginBlock(juce::int64 hostSamples, double ppq, int numSamples);
+
+    // -1..1, at offsetSeconds into the current block
+    float getValue(int voice, double offsetSeconds) const noexcept;
+
+private:
+    // A point on the timeline; beats < 0 when the host gives no musical position
+    struct Position
+    {
+        double seconds = 0.0;
+        double beats = -1.0;
+    };
+
+    // How fast the voices cycle
+    struct Clock
+    {
+        double rateHz = 0.5;
+        double beatsPerCycle = 0.0; // 0 = free rate
+        double beatsPerSecond = 2.0;
+
+        bool operator!=(const Clock& other) const noexcept
+        {
+            return rateHz != other.rateHz || beatsPerCycle != other.beatsPerCycle || beatsPerSecond != other.beatsPerSecond;
+        }
+    };
+
+    Position advance(const Position& position, double seconds) const noexcept;
+    double cyclesAt(const Position& position, double offsetSeconds, const Clock& at) const noexcept; // without phase offset
+    float valueAt(int voice, double cycles) const noexcept;
+
+    double sampleRate = 44100.0;
+    Clock clock;     // in effect for the current block
+    Clock requested; // from setRate/setTempoSync, applied at the next block
+    float randomness = 0.0f;
+
+    double freeRunSeconds = 0.0; // advances while the host gives no position
+    Position block;              // start of the current block
+    double phaseOffset = 0.0;    // cycles, rebased on rate changes
+    double blockLengthSeconds = 0.0;
+    bool hasBlock = false;
+
+    // Where the voices were heading before the last jump, and how far into
+    // the fade the current block starts
+    Position fadeFrom;
+    double fadePhaseOffset = 0.0;
+    double fadeElapsedSeconds = 0.0;
+    bool fading = false;
+
+    std::shared_ptr<const ShapeTables> shapes;
+};
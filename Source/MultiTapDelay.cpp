@@ -0,0 +1,188 @@
+#include "MultiTapDelay.h"
+#include "DelayArena.h"
+#include <cmath>
+
+void MultiTapDelay::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    maxDelaySamples = (float)std::ceil(maxDelaySeconds * spec.sampleRate);
+    numChannels = juce::jmin(maxChannels, (int)spec.numChannels);
+
+    // Room for the full delay behind a whole block written ahead of the reads.
+    size = (int)maxDelaySamples + (int)spec.maximumBlockSize + 2;
+
+    delayCurve.assign(spec.maximumBlockSize, 0.0f);
+    readIndex.assign(spec.maximumBlockSize, 0);
+    readFrac.assign(spec.maximumBlockSize, 0.0f);
+
+    delaySmoothed.reset(spec.sampleRate, 0.05);
+    snapToDelay = true;
+}
+
+size_t MultiTapDelay::getRequiredStorage() const
+{
+    return (size_t)numChannels * DelayArena::alignedSize((size_t)size);
+}
+
+void MultiTapDelay::setStorage(float* storage)
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+        channelData[ch] = ch < numChannels ? storage + (size_t)ch * DelayArena::alignedSize((size_t)size) : nullptr;
+
+    reset();
+}
+
+void MultiTapDelay::reset()
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        if (channelData[ch] != nullptr)
+            juce::FloatVectorOperations::clear(channelData[ch], size);
+
+    writePos = 0;
+    samplesSinceFlush = size;
+    delaySmoothed.setCurrentAndTargetValue(delaySmoothed.getTargetValue());
+    snapToDelay = true;
+}
+
+void MultiTapDelay::flush()
+{
+    samplesSinceFlush = 0;
+}
+
+void MultiTapDelay::setDelay(float delayInSamples)
+{
+    const float target = juce::jlimit(0.0f, maxDelaySamples, delayInSamples);
+
+    // Nothing to glide from yet: start at the delay instead of ramping up from the old one
+    if (snapToDelay)
+        delaySmoothed.setCurrentAndTargetValue(target);
+    else
+        delaySmoothed.setTargetValue(target);
+
+    snapToDelay = false;
+}
+
+void MultiTapDelay::setNumTaps(int newNumTaps)
+{
+    numTaps = juce::jlimit(1, maxTaps, newNumTaps);
+}
+
+void MultiTapDelay::setTap(int index, float gain, float pan)
+{
+    if (! juce::isPositiveAndBelow(index, maxTaps))
+        return;
+
+    tapGain[index] = gain;
+    tapPan[index] = juce::jlimit(-1.0f, 1.0f, pan);
+}
+
+void MultiTapDelay::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    auto& block = context.getOutputBlock();
+    const int numSamples = (int)block.getNumSamples();
+    const int channels = juce::jmin((int)block.getNumChannels(), numChannels);
+
+    // 1. Write the whole block into the shared buffer first; every tap then reads behind it.
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float* in = block.getChannelPointer((size_t)ch);
+        float* ring = channelData[ch];
+
+        const int first = juce::jmin(numSamples, size - writePos);
+        juce::FloatVectorOperations::copy(ring + writePos, in, first);
+        juce::FloatVectorOperations::copy(ring, in + first, numSamples - first);
+    }
+
+    // 2. Per-sample base delay
+    if (delaySmoothed.isSmoothing())
+    {
+        for (int i = 0; i < numSamples; ++i)
+            delayCurve[(size_t)i] = delaySmoothed.getNextValue();
+    }
+    else
+    {
+        juce::FloatVectorOperations::fill(delayCurve.data(), delaySmoothed.getTargetValue(), numSamples);
+    }
+
+    // 3. Gather every tap, accumulating straight into the output block
+    block.clear();
+
+    // After a flush, anything older than the refilled span reads as silence (index -1)
+    const bool checkFlush = samplesSinceFlush < size;
+    const bool cubic = interpolation == Interpolation::cubic;
+    const int reach = cubic ? 2 : 1; // oldest sample behind the integer delay
+
+    for (int t = 0; t < numTaps; ++t)
+    {
+        const float fraction = (float)(t + 1) / (float)numTaps;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float d = delayCurve[(size_t)i] * fraction;
+            const int dInt = (int)d;
+
+            int idx = writePos + i - dInt;
+            if (idx >= size) idx -= size;
+            else if (idx < 0) idx += size;
+
+            if (checkFlush && dInt + reach > samplesSinceFlush + i)
+                idx = -1;
+
+            readIndex[(size_t)i] = idx;
+            readFrac[(size_t)i] = d - (float)dInt;
+        }
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            float gain = tapGain[t];
+            if (channels == 2)
+                gain *= std::min(1.0f, ch == 0 ? 1.0f - tapPan[t] : 1.0f + tapPan[t]);
+
+            const float* ring = channelData[ch];
+            float* out = block.getChannelPointer((size_t)ch);
+
+            if (cubic)
+            {
+                const int lastWritten = (writePos + numSamples - 1) % size;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const int newer = readIndex[(size_t)i];
+                    if (newer < 0)
+                        continue;
+
+                    // The sample after 'newer' is not written yet at zero delay
+                    const int newest = newer == lastWritten ? newer : (newer + 1 == size ? 0 : newer + 1);
+                    const int older = newer == 0 ? size - 1 : newer - 1;
+                    const int oldest = older == 0 ? size - 1 : older - 1;
+
+                    const float xm1 = ring[newest], x0 = ring[newer], x1 = ring[older], x2 = ring[oldest];
+                    const float c1 = 0.5f * (x1 - xm1);
+                    const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+                    const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+                    const float f = readFrac[(size_t)i];
+
+                    out[i] += gain * (((c3 * f + c2) * f + c1) * f + x0);
+                }
+            }
+            else
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const int newer = readIndex[(size_t)i];
+                    if (newer < 0)
+                        continue;
+
+                    const int older = newer == 0 ? size - 1 : newer - 1;
+                    const float v = ring[newer] + readFrac[(size_t)i] * (ring[older] - ring[newer]);
+
+                    out[i] += gain * v;
+                }
+            }
+        }
+    }
+
+    writePos = (writePos + numSamples) % size;
+
+    if (checkFlush)
+        samplesSinceFlush = juce::jmin(size, samplesSinceFlush + numSamples);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+// Pre-delay with up to maxTaps taps read from one shared circular buffer per
+// channel. Tap k of N sits at k/N of the delay time, so the last tap is always
+// the full pre-delay. The delay time ramps per sample, so tempo changes glide
+// instead of jumping at block boundaries. The first delay set after prepare()
+// or reset() applies at once.
+//
+// The circular buffers live in the owner's DelayArena: prepare() sizes them,
+// setStorage() hands them over.
+class MultiTapDelay
+{
+public:
+    static constexpr int maxTaps = 4;
+    static constexpr int maxChannels = 2;
+
+    // DELAY stops at 1 s; synced values may run up to 2 s, the buffer the
+    // engine has always had. Longer ones (1/2. below 90 bpm, 1/2 below
+    // 60 bpm) clamp to it rather than growing every instance's memory.
+    static constexpr double maxDelaySeconds = 2.0;
+
+    enum class Interpolation { linear, cubic }; // cubic = 4-point Hermite
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    size_t getRequiredStorage() const;
+    void setStorage(float* storage);
+    void reset();
+
+    // Forgets the buffered audio in O(1): reads reaching further back than the
+    // samples written since the flush return silence until the buffer refills.
+    void flush();
+
+    void setDelay(float delayInSamples);
+    void setNumTaps(int newNumTaps);
+    void setTap(int index, float gain, float pan); // gain 0..1, pan -1..1
+    void setInterpolation(Interpolation newInterpolation) { interpolation = newInterpolation; }
+
+    float getMaximumDelayInSamples() const { return maxDelaySamples; }
+
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+
+private:
+    float* channelData[maxChannels] = { nullptr, nullptr };
+    int numChannels = 0;
+    int size = 0;
+    int writePos = 0;
+    float maxDelaySamples = 0.0f;
+    int samplesSinceFlush = 0;
+    bool snapToDelay = true; // the next setDelay() jumps instead of gliding
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> delaySmoothed;
+
+    // Per-block scratch: base delay curve, and the read index/fraction of the
+    // tap currently being gathered (shared by all channels).
+    std::vector<float> delayCurve;
+    std::vector<int> readIndex;
+    std::vector<float> readFrac;
+
+    Interpolation interpolation = Interpolation::linear;
+
+    int numTaps = 1;
+    float tapGain[maxTaps] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float tapPan[maxTaps] = { 0.0f, 0.0f, 0.0f, 0.0f };
+};
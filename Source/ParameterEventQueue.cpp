@@ -0,0 +1,35 @@
+#include "ParameterEventQueue.h"
+
+bool ParameterEventQueue::post(const Event& event) noexcept
+{
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+        return false;
+
+    slots[(size_t)(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = event;
+    return true;
+}
+
+int ParameterEventQueue::collect(int numSamples) noexcept
+{
+    const auto scope = fifo.read(fifo.getNumReady());
+    int count = 0;
+
+    scope.forEach([&](int slot) {
+        Event event = slots[(size_t)slot];
+        const int lastOffset = juce::jmax(0, numSamples - 1);
+        const int offset = juce::jlimit(0, lastOffset, event.sampleOffset);
+        event.sampleOffset = offset / minSubBlockSamples * minSubBlockSamples;
+
+        // Insertion sort: a handful of events per block, and stable
+        int pos = count++;
+        while (pos > 0 && blockEvents[(size_t)pos - 1].sampleOffset > event.sampleOffset)
+        {
+            blockEvents[(size_t)pos] = blockEvents[(size_t)pos - 1];
+            --pos;
+        }
+        blockEvents[(size_t)pos] = event;
+    });
+
+    return count;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+
+// Lock-free queue of timed parameter changes for the next processBlock. The
+// block is split at the event offsets and each change is applied to the
+// parameter and its APVTS value exactly where it falls, snapped down to a
+// grid of minSubBlockSamples. The grid bounds the number of splits, so the
+// vector loops never run on a handful of samples.
+//
+// One producer thread and one consumer (the audio thread) at a time.
+class ParameterEventQueue
+{
+public:
+    static constexpr int capacity = 512;
+    static constexpr int minSubBlockSamples = 32;
+
+    struct Event
+    {
+        juce::RangedAudioParameter* parameter = nullptr;
+        std::atomic<float>* rawValue = nullptr; // the APVTS value readParameters() reads
+        float normalisedValue = 0.0f;
+        int sampleOffset = 0;
+    };
+
+    // Producer. Returns false (and drops the event) when the queue is full.
+    bool post(const Event& event) noexcept;
+
+    // Consumer, at the start of a block: takes every posted event, sorted by
+    // offset (posting order kept within an offset) and snapped to the grid.
+    // Offsets past the end of the block apply at its last grid point.
+    int collect(int numSamples) noexcept;
+
+    const Event& operator[](int index) const noexcept { return blockEvents[(size_t)index]; }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<Event, capacity> slots;
+    std::array<Event, capacity> blockEvents;
+};
@@ -25,6 +25,7 @@ FDNRAudioProcessorEditor::FDNRAudioProcessorEditor (FDNRAudioProcessor& p)
     addSlider(modDepthSlider, modDepthAtt, "MODDEPTH", "DEPTH");
     addSlider(saturationSlider, saturationAtt, "SATURATION", "SAT");
     addSlider(gateThreshSlider, gateThreshAtt, "GATE_THRESH", "GATE");
+    addToggle(freezeButton, freezeAtt, "FREEZE", "FREEZE");
 
     // Filter Group
     addSlider(dynFreqSlider, dynFreqAtt, "DYNFREQ", "DYN FREQ");
@@ -36,7 +37,7 @@ FDNRAudioProcessorEditor::FDNRAudioProcessorEditor (FDNRAudioProcessor& p)
     addSlider(eqHighSlider, eqHighAtt, "EQ3_HIGH", "HIGH");
 
     // Utility Group
-    preDelaySyncBox.addItemList({"Free", "1/4", "1/8", "1/16"}, 1);
+    preDelaySyncBox.addItemList(audioProcessor.getAPVTS().getParameter("PREDELAY_SYNC")->getAllValueStrings(), 1);
     preDelaySyncBox.setTextWhenNothingSelected("Default");
     addComboBox(preDelaySyncBox, preDelaySyncAtt, "PREDELAY_SYNC", "SYNC");
 
@@ -68,15 +69,16 @@ FDNRAudioProcessorEditor::FDNRAudioProcessorEditor (FDNRAudioProcessor& p)
 
     addAndMakeVisible(savePresetButton);
     savePresetButton.onClick = [this]() {
-        fileChooser = std::make_unique<juce::FileChooser>("Save", juce::File::getSpecialLocation(juce::File::userHomeDirectory), "*.json");
+        fileChooser = std::make_unique<juce::FileChooser>("Save", audioProcessor.getPresetLibrary().getDirectory(), "*.json");
         fileChooser->launchAsync(juce::FileBrowserComponent::saveMode, [this](const juce::FileChooser& c) { audioProcessor.savePreset(c.getResult().withFileExtension("json")); });
     };
 
     addAndMakeVisible(loadPresetButton);
-    loadPresetButton.onClick = [this]() {
-        fileChooser = std::make_unique<juce::FileChooser>("Load", juce::File::getSpecialLocation(juce::File::userHomeDirectory), "*.json");
-        fileChooser->launchAsync(juce::FileBrowserComponent::openMode, [this](const juce::FileChooser& c) { audioProcessor.loadPreset(c.getResult()); });
-    };
+    loadPresetButton.onClick = [this]() { showPresetMenu(); };
+
+    addAndMakeVisible(moreButton);
+    moreButton.setTooltip("All parameters, including the band decays, EQ frequencies, taps, detector, quality and mod sync");
+    moreButton.onClick = [this]() { showAllParameters(); };
 
 
 
@@ -87,6 +89,52 @@ FDNRAudioProcessorEditor::FDNRAudioProcessorEditor (FDNRAudioProcessor& p)
 
 FDNRAudioProcessorEditor::~FDNRAudioProcessorEditor() { setLookAndFeel(nullptr); }
 
+void FDNRAudioProcessorEditor::showPresetMenu()
+{
+    auto& library = audioProcessor.getPresetLibrary();
+    const auto snapshot = library.getSnapshot();
+
+    // Entries are applied from the index; the menu items keep the snapshot alive
+    auto addEntries = [this, snapshot](juce::PopupMenu& menu, const std::vector<const PresetLibrary::Entry*>& entries) {
+        for (auto* entry : entries)
+            menu.addItem(entry->name, [this, snapshot, entry] { audioProcessor.loadPreset(*entry); });
+    };
+
+    juce::PopupMenu menu;
+
+    if (! library.hasScanned())
+        menu.addItem("Scanning presets...", false, false, nullptr);
+    else if (snapshot->empty())
+        menu.addItem("No presets saved yet", false, false, nullptr);
+    else
+    {
+        addEntries(menu, PresetLibrary::search(*snapshot, {}));
+
+        const auto& space = library.getParameterSpace();
+        juce::PopupMenu similar;
+        addEntries(similar, PresetLibrary::findSimilar(*snapshot, space, space.makeVector(audioProcessor), 8));
+
+        menu.addSeparator();
+        menu.addSubMenu("Similar to Current", similar);
+    }
+
+    menu.addSeparator();
+    menu.addItem("Browse...", [this] {
+        fileChooser = std::make_unique<juce::FileChooser>("Load", audioProcessor.getPresetLibrary().getDirectory(), "*.json");
+        fileChooser->launchAsync(juce::FileBrowserComponent::openMode, [this](const juce::FileChooser& c) { audioProcessor.loadPreset(c.getResult()); });
+    });
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&loadPresetButton));
+}
+
+void FDNRAudioProcessorEditor::showAllParameters()
+{
+    // A child of the editor, so it goes away with it
+    auto panel = std::make_unique<juce::GenericAudioProcessorEditor>(audioProcessor);
+    panel->setSize(420, juce::jmin(480, getHeight() - 80));
+    juce::CallOutBox::launchAsynchronously(std::move(panel), moreButton.getBounds(), this);
+}
+
 void FDNRAudioProcessorEditor::addSlider(juce::Slider& slider, std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>& attachment, const juce::String& paramID, const juce::String& name)
 {
     slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
@@ -237,6 +285,9 @@ void FDNRAudioProcessorEditor::resized()
 
         auto row3 = r.removeFromTop(rowH);
         gateThreshSlider.setBounds(row3.removeFromLeft(colW).reduced(5, 4));
+
+        int buttonHeight = (row3.getHeight() - 8) / 2;
+        freezeButton.setBounds(row3.getX() + 5, row3.getCentreY() - buttonHeight / 2, row3.getWidth() - 10, buttonHeight);
     }
 
     // 4. FILTERS / EQ
@@ -301,5 +352,5 @@ void FDNRAudioProcessorEditor::resized()
     }
 
     // Bottom Bar
-
+    moreButton.setBounds(bottomBar.withSizeKeepingCentre(120, bottomBar.getHeight() / 2));
 }
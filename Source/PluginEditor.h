@@ -196,6 +196,12 @@ private:
     void addComboBox(juce::ComboBox& box, std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment, const juce::String& paramID, const juce::String& name);
     void addToggle(juce::ToggleButton& button, std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment>& attachment, const juce::String& paramID, const juce::String& name);
 
+    // LOAD: the library's presets, those nearest the current settings, and a file browser
+    void showPresetMenu();
+
+    // MORE: a generic panel of all parameters in a call-out over the editor
+    void showAllParameters();
+
     // Sliders & Controls
     juce::Slider mixSlider, widthSlider, duckingSlider;
     juce::ComboBox preDelaySyncBox;
@@ -208,7 +214,7 @@ private:
 
     juce::Slider eqLowSlider, eqMidSlider, eqHighSlider;
     juce::Slider msBalanceSlider, gateThreshSlider, abMorphSlider;
-    juce::ToggleButton limiterButton, abSwitchButton;
+    juce::ToggleButton limiterButton, abSwitchButton, freezeButton;
 
     // Attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAtt, widthAtt, duckingAtt;
@@ -220,7 +226,7 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eqLowAtt, eqMidAtt, eqHighAtt;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> msBalanceAtt, gateThreshAtt, abMorphAtt;
 
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAtt, abSwitchAtt;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> limiterAtt, abSwitchAtt, freezeAtt;
 
     std::vector<std::unique_ptr<juce::Label>> labels;
 
@@ -234,6 +240,7 @@ private:
     juce::TextButton clearButton { "CLEAR" };
     juce::TextButton savePresetButton { "SAVE" };
     juce::TextButton loadPresetButton { "LOAD" };
+    juce::TextButton moreButton { "MORE" }; // every parameter, for those without a control of their own
     std::unique_ptr<juce::FileChooser> fileChooser;
     juce::TooltipWindow tooltipWindow;
 
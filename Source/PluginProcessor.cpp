@@ -7,12 +7,12 @@ FDNRAudioProcessor::FDNRAudioProcessor()
      : AudioProcessor (BusesProperties()
                      .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                      .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                      ),
        apvts(*this, nullptr, "Parameters", createParameterLayout())
 #endif
 {
-    stateA = apvts.copyState();
-    stateB = apvts.copyState();
+    // The A/B slots are only filled once the user switches (see toggleAB)
 }
 
 FDNRAudioProcessor::~FDNRAudioProcessor()
@@ -42,22 +42,72 @@ juce::AudioProcessorValueTreeState::ParameterLayout FDNRAudioProcessor::createPa
     // New Features
     layout.add(std::make_unique<juce::AudioParameterFloat>("DUCKING", "Ducking", 0.0f, 100.0f, 0.0f));
 
+    juce::StringArray detectorOptions;
+    detectorOptions.add("Dry L+R"); detectorOptions.add("Mid"); detectorOptions.add("Sidechain");
+    layout.add(std::make_unique<juce::AudioParameterChoice>("DETECTOR", "Detector", detectorOptions, 0));
+
     juce::StringArray syncOptions;
     syncOptions.add("Free"); syncOptions.add("1/4"); syncOptions.add("1/8"); syncOptions.add("1/16");
+    syncOptions.add("1/2");
+    syncOptions.add("1/2."); syncOptions.add("1/4."); syncOptions.add("1/8."); syncOptions.add("1/16.");
+    syncOptions.add("1/2T"); syncOptions.add("1/4T"); syncOptions.add("1/8T"); syncOptions.add("1/16T");
     layout.add(std::make_unique<juce::AudioParameterChoice>("PREDELAY_SYNC", "Sync", syncOptions, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("MOD_SYNC", "Mod Sync", syncOptions, 0));
+
+    // Multi-tap pre-delay: tap k of N sits at k/N of the delay time
+    layout.add(std::make_unique<juce::AudioParameterInt>("PREDELAY_TAPS", "Taps", 1, MultiTapDelay::maxTaps, 1));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP1_GAIN", "Tap 1 Gain", 0.0f, 100.0f, 100.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP2_GAIN", "Tap 2 Gain", 0.0f, 100.0f, 100.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP3_GAIN", "Tap 3 Gain", 0.0f, 100.0f, 100.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP4_GAIN", "Tap 4 Gain", 0.0f, 100.0f, 100.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP1_PAN", "Tap 1 Pan", -100.0f, 100.0f, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP2_PAN", "Tap 2 Pan", -100.0f, 100.0f, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP3_PAN", "Tap 3 Pan", -100.0f, 100.0f, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("TAP4_PAN", "Tap 4 Pan", -100.0f, 100.0f, 0.0f));
 
     layout.add(std::make_unique<juce::AudioParameterFloat>("SATURATION", "Saturation", 0.0f, 100.0f, 0.0f));
     layout.add(std::make_unique<juce::AudioParameterFloat>("DIFFUSION", "Diffusion", 0.0f, 100.0f, 100.0f));
 
+    // Decay shaping: RT60 multipliers per band, applied inside the network loop
+    juce::NormalisableRange<float> decayRange(0.25f, 4.0f, 0.01f);
+    decayRange.setSkewForCentre(1.0f);
+    layout.add(std::make_unique<juce::AudioParameterFloat>("DECAY_LOW", "Low Decay", decayRange, 1.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("DECAY_MID", "Mid Decay", decayRange, 1.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("DECAY_HIGH", "High Decay", decayRange, 1.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("DECAY_LOW_FREQ", "Low Crossover", juce::NormalisableRange<float>(50.0f, 1000.0f, 1.0f, 0.4f), 250.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("DECAY_HIGH_FREQ", "High Crossover", juce::NormalisableRange<float>(1000.0f, 16000.0f, 1.0f, 0.3f), 4000.0f));
+
     layout.add(std::make_unique<juce::AudioParameterFloat>("GATE_THRESH", "Gate Thresh", -100.0f, 0.0f, -100.0f));
 
     // 3-Band EQ
     layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_LOW", "Low Gain", -12.0f, 12.0f, 0.0f));
     layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_MID", "Mid Gain", -12.0f, 12.0f, 0.0f));
     layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_HIGH", "High Gain", -12.0f, 12.0f, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_LOW_FREQ", "Low Freq", juce::NormalisableRange<float>(20.0f, 1000.0f, 1.0f, 0.4f), 200.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_MID_FREQ", "Mid Freq", juce::NormalisableRange<float>(200.0f, 8000.0f, 1.0f, 0.3f), 1000.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_MID_Q", "Mid Q", juce::NormalisableRange<float>(0.1f, 10.0f, 0.01f, 0.4f), 1.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("EQ3_HIGH_FREQ", "High Freq", juce::NormalisableRange<float>(1000.0f, 20000.0f, 1.0f, 0.3f), 6000.0f));
+
+    juce::StringArray eqPhaseOptions;
+    eqPhaseOptions.add("Minimum"); eqPhaseOptions.add("Linear");
+    layout.add(std::make_unique<juce::AudioParameterChoice>("EQ3_PHASE", "EQ Phase", eqPhaseOptions, 0));
 
     layout.add(std::make_unique<juce::AudioParameterFloat>("MS_BALANCE", "M/S Bal", 0.0f, 100.0f, 50.0f));
     layout.add(std::make_unique<juce::AudioParameterBool>("LIMITER", "Limiter", true));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("LIMITER_LOOKAHEAD", "Lookahead", 0.0f, TruePeakLimiter::maxLookaheadMs, 1.0f));
+    layout.add(std::make_unique<juce::AudioParameterBool>("FREEZE", "Freeze", false));
+
+    juce::StringArray stopOptions;
+    stopOptions.add("Ring Out"); stopOptions.add("Fade"); stopOptions.add("Flush");
+    layout.add(std::make_unique<juce::AudioParameterChoice>("ON_STOP", "On Stop", stopOptions, 0));
+
+    juce::StringArray qualityOptions;
+    qualityOptions.add("Eco"); qualityOptions.add("Normal"); qualityOptions.add("High");
+    layout.add(std::make_unique<juce::AudioParameterChoice>("QUALITY", "Quality", qualityOptions, 1));
+
+    juce::StringArray rateOptions;
+    rateOptions.add("Full"); rateOptions.add("1/2"); rateOptions.add("1/4");
+    layout.add(std::make_unique<juce::AudioParameterChoice>("REVERB_RATE", "Reverb Rate", rateOptions, 0));
 
     // A/B Switch
     layout.add(std::make_unique<juce::AudioParameterBool>("AB_SWITCH", "A/B", false));
@@ -142,9 +192,16 @@ void FDNRAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumOutputChannels();
+    spec.numChannels = getMainBusNumOutputChannels();
 
+    reverbProcessor.setMonoInput(getMainBusNumInputChannels() == 1 && spec.numChannels == 2);
+    sidechainCopy.setSize(2, samplesPerBlock);
+
+    // The session's settings go in first: prepare lays the network out for
+    // its quality tier and rate, and the latency depends on the lookahead
+    reverbProcessor.setParameters(readParameters());
     reverbProcessor.prepare(spec);
+    setLatencySamples(reverbProcessor.getLatencyInSamples());
 }
 
 void FDNRAudioProcessor::releaseResources()
@@ -164,10 +221,23 @@ bool FDNRAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) con
         return false;
 
    #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+    // Same layout in and out, or mono into stereo (see ReverbProcessor::setMonoInput)
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet()
+     && ! (layouts.getMainInputChannelSet() == juce::AudioChannelSet::mono()
+        && layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo()))
         return false;
    #endif
 
+    // Optional sidechain: disabled, mono or stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet (true, 1);
+        if (! sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
     return true;
   #endif
 }
@@ -176,12 +246,123 @@ bool FDNRAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) con
 void FDNRAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    auto mainBuffer = getBusBuffer (buffer, false, 0);
+    auto sidechainBuffer = getBusBuffer (buffer, true, 1);
+
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
+    auto totalNumOutputChannels = getMainBusNumOutputChannels();
+
+    // Mono into stereo: the sidechain's first channel is main output channel
+    // 1 in the host buffer, so take a copy of the key before the output is
+    // cleared and written
+    if (totalNumInputChannels < totalNumOutputChannels && sidechainBuffer.getNumChannels() > 0)
+    {
+        const int numKeyChannels = sidechainBuffer.getNumChannels();
+        const int numKeySamples = sidechainBuffer.getNumSamples();
+        sidechainCopy.setSize(numKeyChannels, numKeySamples, false, false, true);
+
+        for (int ch = 0; ch < numKeyChannels; ++ch)
+            sidechainCopy.copyFrom(ch, 0, sidechainBuffer, ch, 0, numKeySamples);
+
+        sidechainBuffer = juce::AudioBuffer<float>(sidechainCopy.getArrayOfWritePointers(), numKeyChannels, numKeySamples);
+    }
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+        mainBuffer.clear (i, 0, mainBuffer.getNumSamples());
+
+    bool transportStopped = false;
+    juce::int64 timeInSamples = -1;
+    double ppqPosition = -1.0;
+    double bpm = ReverbParameters().bpm;
+
+    if (auto* ph = getPlayHead())
+    {
+        if (auto position = ph->getPosition())
+        {
+            if (auto hostBpm = position->getBpm())
+                bpm = *hostBpm; // Tempo changes glide in the pre-delay
+
+            const bool isPlaying = position->getIsPlaying();
+
+            if (isPlaying)
+            {
+                // Modulation phase follows the timeline (see ModulationBank)
+                if (auto samples = position->getTimeInSamples())
+                    timeInSamples = *samples;
+                if (auto ppq = position->getPpqPosition())
+                    ppqPosition = *ppq;
+            }
+            transportStopped = wasPlaying && ! isPlaying;
+            wasPlaying = isPlaying;
+        }
+    }
+
+    // Split the block where queued parameter changes fall; without any, this
+    // is a single pass over the whole buffer.
+    const int numSamples = mainBuffer.getNumSamples();
+    const int numEvents = parameterEvents.collect(numSamples);
+    int nextEvent = 0;
+
+    for (int start = 0; start < numSamples;)
+    {
+        while (nextEvent < numEvents && parameterEvents[nextEvent].sampleOffset <= start)
+        {
+            // Without the listener callback, which would take the parameter's
+            // listener lock here and report the change back to the host
+            const auto& event = parameterEvents[nextEvent++];
+            event.parameter->setValue(event.normalisedValue);
+            event.rawValue->store(event.parameter->convertFrom0to1(event.normalisedValue));
+        }
+
+        const int end = nextEvent < numEvents ? parameterEvents[nextEvent].sampleOffset : numSamples;
+
+        ReverbParameters params = readParameters();
+        params.bpm = bpm;
+        if (timeInSamples >= 0)
+            params.timeInSamples = timeInSamples + start;
+        if (ppqPosition >= 0.0)
+            params.ppqPosition = ppqPosition + start / getSampleRate() * bpm / 60.0;
+
+        reverbProcessor.setParameters(params);
+
+        if (reverbProcessor.getLatencyInSamples() != getLatencySamples())
+            setLatencySamples(reverbProcessor.getLatencyInSamples());
+
+        if (start == 0)
+        {
+            if (clearTriggered.exchange(false))
+            {
+                reverbProcessor.fadeOutTail(0.005f);
+            }
+
+            if (transportStopped)
+            {
+                auto onStop = (int)apvts.getRawParameterValue("ON_STOP")->load();
+                if (onStop == 1) reverbProcessor.fadeOutTail(0.25f);        // Fade
+                else if (onStop == 2) reverbProcessor.fadeOutTail(0.005f);  // Flush
+            }
+        }
+
+        juce::dsp::AudioBlock<float> block = juce::dsp::AudioBlock<float>(mainBuffer).getSubBlock((size_t)start, (size_t)(end - start));
+        juce::dsp::ProcessContextReplacing<float> context(block);
+        juce::dsp::AudioBlock<const float> sidechainBlock = juce::dsp::AudioBlock<const float>(sidechainBuffer).getSubBlock((size_t)start, (size_t)(end - start));
+
+        reverbProcessor.process(context, sidechainBlock);
+        start = end;
+    }
+}
 
+bool FDNRAudioProcessor::postParameterChange(const juce::String& parameterID, float normalisedValue, int sampleOffset)
+{
+    auto* parameter = apvts.getParameter(parameterID);
+    if (parameter == nullptr)
+        return false;
+
+    return parameterEvents.post({ parameter, apvts.getRawParameterValue(parameterID), normalisedValue, sampleOffset });
+}
+
+ReverbParameters FDNRAudioProcessor::readParameters() const
+{
     ReverbParameters params;
     params.mix = apvts.getRawParameterValue("MIX")->load();
     params.width = apvts.getRawParameterValue("WIDTH")->load();
@@ -199,38 +380,46 @@ void FDNRAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::M
     params.dynThresh = apvts.getRawParameterValue("DYNTHRESH")->load();
 
     params.ducking = apvts.getRawParameterValue("DUCKING")->load();
+    params.detectorSource = (int)apvts.getRawParameterValue("DETECTOR")->load();
     params.preDelaySync = (int)apvts.getRawParameterValue("PREDELAY_SYNC")->load();
+    params.modSync = (int)apvts.getRawParameterValue("MOD_SYNC")->load();
+    params.preDelayTaps = (int)apvts.getRawParameterValue("PREDELAY_TAPS")->load();
+    params.tapGain[0] = apvts.getRawParameterValue("TAP1_GAIN")->load();
+    params.tapGain[1] = apvts.getRawParameterValue("TAP2_GAIN")->load();
+    params.tapGain[2] = apvts.getRawParameterValue("TAP3_GAIN")->load();
+    params.tapGain[3] = apvts.getRawParameterValue("TAP4_GAIN")->load();
+    params.tapPan[0] = apvts.getRawParameterValue("TAP1_PAN")->load();
+    params.tapPan[1] = apvts.getRawParameterValue("TAP2_PAN")->load();
+    params.tapPan[2] = apvts.getRawParameterValue("TAP3_PAN")->load();
+    params.tapPan[3] = apvts.getRawParameterValue("TAP4_PAN")->load();
     params.saturation = apvts.getRawParameterValue("SATURATION")->load();
     params.diffusion = apvts.getRawParameterValue("DIFFUSION")->load();
+    params.decayLow = apvts.getRawParameterValue("DECAY_LOW")->load();
+    params.decayMid = apvts.getRawParameterValue("DECAY_MID")->load();
+    params.decayHigh = apvts.getRawParameterValue("DECAY_HIGH")->load();
+    params.decayLowFreq = apvts.getRawParameterValue("DECAY_LOW_FREQ")->load();
+    params.decayHighFreq = apvts.getRawParameterValue("DECAY_HIGH_FREQ")->load();
     params.gateThresh = apvts.getRawParameterValue("GATE_THRESH")->load();
 
     params.eq3Low = apvts.getRawParameterValue("EQ3_LOW")->load();
     params.eq3Mid = apvts.getRawParameterValue("EQ3_MID")->load();
     params.eq3High = apvts.getRawParameterValue("EQ3_HIGH")->load();
+    params.eq3LowFreq = apvts.getRawParameterValue("EQ3_LOW_FREQ")->load();
+    params.eq3MidFreq = apvts.getRawParameterValue("EQ3_MID_FREQ")->load();
+    params.eq3MidQ = apvts.getRawParameterValue("EQ3_MID_Q")->load();
+    params.eq3HighFreq = apvts.getRawParameterValue("EQ3_HIGH_FREQ")->load();
+    params.eq3Phase = (int)apvts.getRawParameterValue("EQ3_PHASE")->load();
 
     params.msBalance = apvts.getRawParameterValue("MS_BALANCE")->load();
     params.limiterOn = (apvts.getRawParameterValue("LIMITER")->load() > 0.5f);
+    params.limiterLookahead = apvts.getRawParameterValue("LIMITER_LOOKAHEAD")->load();
+    params.freeze = (apvts.getRawParameterValue("FREEZE")->load() > 0.5f);
+    params.quality = (int)apvts.getRawParameterValue("QUALITY")->load();
+    params.reverbRate = (int)apvts.getRawParameterValue("REVERB_RATE")->load();
 
     params.mode = (int)apvts.getRawParameterValue("MODE")->load();
 
-    if (auto* ph = getPlayHead())
-    {
-        juce::AudioPlayHead::CurrentPositionInfo info;
-        if (ph->getCurrentPosition(info))
-            params.bpm = info.bpm;
-    }
-
-    reverbProcessor.setParameters(params);
-
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-
-    if (clearTriggered.exchange(false))
-    {
-        reverbProcessor.reset();
-    }
-
-    reverbProcessor.process(context);
+    return params;
 }
 
 //==============================================================================
@@ -261,7 +450,7 @@ void FDNRAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
             apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
 }
 
-void FDNRAudioProcessor::savePreset(const juce::File& file)
+void FDNRAudioProcessor::savePreset(const juce::File& file, const juce::StringArray& tags)
 {
     auto state = apvts.copyState();
     juce::DynamicObject* jsonObject = new juce::DynamicObject();
@@ -276,6 +465,12 @@ void FDNRAudioProcessor::savePreset(const juce::File& file)
         }
     }
 
+    juce::Array<juce::var> tagArray;
+    for (auto& tag : tags)
+        tagArray.add(tag);
+
+    jsonObject->setProperty("name", file.getFileNameWithoutExtension());
+    jsonObject->setProperty("tags", tagArray);
     jsonObject->setProperty("parameters", paramsObject);
     jsonObject->setProperty("pluginVersion", JucePlugin_VersionString);
     jsonObject->setProperty("pluginName", JucePlugin_Name);
@@ -284,6 +479,9 @@ void FDNRAudioProcessor::savePreset(const juce::File& file)
     juce::String jsonString = juce::JSON::toString(jsonVar);
 
     file.replaceWithText(jsonString);
+
+    if (presetLibrary != nullptr && file.isAChildOf(presetLibrary->getDirectory()))
+        presetLibrary->rescan();
 }
 
 void FDNRAudioProcessor::loadPreset(const juce::File& file)
@@ -320,6 +518,48 @@ void FDNRAudioProcessor::loadPreset(const juce::File& file)
     }
 }
 
+void FDNRAudioProcessor::loadPreset(const PresetLibrary::Entry& entry)
+{
+    const auto& space = getPresetLibrary().getParameterSpace();
+    if (entry.values.size() != (size_t)space.size() || entry.stored.size() != entry.values.size()) return;
+
+    // Like loading the file: parameters the preset does not set are left alone
+    for (int i = 0; i < space.size(); ++i)
+    {
+        if (! entry.stored[(size_t)i])
+            continue;
+
+        auto paramValue = apvts.getParameterAsValue(space.ids[i]);
+        if (paramValue.refersToSameSourceAs(juce::Value()))
+            continue;
+
+        paramValue.setValue(space.ranges.getReference(i).convertFrom0to1(entry.values[(size_t)i]));
+    }
+}
+
+PresetLibrary& FDNRAudioProcessor::getPresetLibrary()
+{
+    // Created on first use rather than in the constructor, so hosts loading
+    // many instances never pay for the scan
+    if (presetLibrary == nullptr)
+        presetLibrary = std::make_unique<PresetLibrary>(getDefaultPresetDirectory(),
+                                                        PresetLibrary::ParameterSpace::fromProcessor(*this, getNonSoundParameterIDs()));
+
+    return *presetLibrary;
+}
+
+juce::StringArray FDNRAudioProcessor::getNonSoundParameterIDs()
+{
+    // MODE only selects a starting point; the parameters it sets are compared instead
+    return { "AB_SWITCH", "QUALITY", "REVERB_RATE", "ON_STOP", "FREEZE", "MODE" };
+}
+
+juce::File FDNRAudioProcessor::getDefaultPresetDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Stancsz Audio").getChildFile("FND Reverb").getChildFile("Presets");
+}
+
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new FDNRAudioProcessor();
@@ -348,19 +588,46 @@ void FDNRAudioProcessor::resetAllParametersToDefault()
     resetParam("DYNTHRESH", -20.0f);
 
     resetParam("DUCKING", 0.0f);
+    resetParam("DETECTOR", 0.0f); // Dry L+R
     resetParam("PREDELAY_SYNC", 0.0f); // Free
+    resetParam("MOD_SYNC", 0.0f); // Free
+    resetParam("PREDELAY_TAPS", 1.0f);
+    resetParam("TAP1_GAIN", 100.0f);
+    resetParam("TAP2_GAIN", 100.0f);
+    resetParam("TAP3_GAIN", 100.0f);
+    resetParam("TAP4_GAIN", 100.0f);
+    resetParam("TAP1_PAN", 0.0f);
+    resetParam("TAP2_PAN", 0.0f);
+    resetParam("TAP3_PAN", 0.0f);
+    resetParam("TAP4_PAN", 0.0f);
     resetParam("SATURATION", 0.0f);
     resetParam("DIFFUSION", 100.0f);
+    resetParam("DECAY_LOW", 1.0f);
+    resetParam("DECAY_MID", 1.0f);
+    resetParam("DECAY_HIGH", 1.0f);
+    resetParam("DECAY_LOW_FREQ", 250.0f);
+    resetParam("DECAY_HIGH_FREQ", 4000.0f);
     resetParam("GATE_THRESH", -100.0f);
 
     resetParam("EQ3_LOW", 0.0f);
     resetParam("EQ3_MID", 0.0f);
     resetParam("EQ3_HIGH", 0.0f);
+    resetParam("EQ3_LOW_FREQ", 200.0f);
+    resetParam("EQ3_MID_FREQ", 1000.0f);
+    resetParam("EQ3_MID_Q", 1.0f);
+    resetParam("EQ3_HIGH_FREQ", 6000.0f);
+    resetParam("EQ3_PHASE", 0.0f); // Minimum
 
     resetParam("MS_BALANCE", 50.0f);
 
     if (auto* p = apvts.getParameter("LIMITER")) 
         apvts.getParameterAsValue("LIMITER").setValue(true); // On by default
+    resetParam("LIMITER_LOOKAHEAD", 1.0f);
+
+    resetParam("FREEZE", 0.0f);
+    resetParam("ON_STOP", 0.0f); // Ring Out
+    resetParam("QUALITY", 1.0f); // Normal
+    resetParam("REVERB_RATE", 0.0f); // Full
 }
 
 void FDNRAudioProcessor::setParametersForMode(int modeIndex)
@@ -379,6 +646,15 @@ void FDNRAudioProcessor::setParametersForMode(int modeIndex)
         setParam("GATE_THRESH", -100.0f);
         setParam("DYNFREQ", 1000.0f);
         setParam("DYNGAIN", 0.0f);
+        setParam("PREDELAY_TAPS", 1.0f);
+        setParam("TAP1_GAIN", 100.0f);
+        setParam("TAP2_GAIN", 100.0f);
+        setParam("TAP3_GAIN", 100.0f);
+        setParam("TAP4_GAIN", 100.0f);
+        setParam("TAP1_PAN", 0.0f);
+        setParam("TAP2_PAN", 0.0f);
+        setParam("TAP3_PAN", 0.0f);
+        setParam("TAP4_PAN", 0.0f);
     };
 
     resetModifiers();
@@ -655,6 +931,15 @@ void FDNRAudioProcessor::setParametersForMode(int modeIndex)
             setParam("MODRATE", 2.0f);
             setParam("MODDEPTH", 50.0f);
             setParam("EQ3_HIGH", 8.0f); // Shimmer brightness
+            setParam("PREDELAY_TAPS", 4.0f); // Scattered taps ahead of the main one
+            setParam("TAP1_GAIN", 45.0f);
+            setParam("TAP1_PAN", -70.0f);
+            setParam("TAP2_GAIN", 60.0f);
+            setParam("TAP2_PAN", 70.0f);
+            setParam("TAP3_GAIN", 75.0f);
+            setParam("TAP3_PAN", -35.0f);
+            setParam("TAP4_GAIN", 100.0f);
+            setParam("TAP4_PAN", 15.0f);
             break;
 
         default:
@@ -668,7 +953,12 @@ void FDNRAudioProcessor::toggleAB()
     if (isStateA)
     {
         stateA = apvts.copyState();
-        apvts.replaceState(stateB);
+
+        // B starts as a copy of A the first time round, so nothing changes
+        // until it is edited
+        if (stateB.isValid())
+            apvts.replaceState(stateB);
+
         isStateA = false;
     }
     else
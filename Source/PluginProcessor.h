@@ -3,6 +3,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include "ReverbProcessor.h"
+#include "ParameterEventQueue.h"
+#include "PresetLibrary.h"
 
 class FDNRAudioProcessor  : public juce::AudioProcessor
 {
@@ -48,14 +50,44 @@ public:
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
     // Preset Management
-    void savePreset(const juce::File& file);
+    void savePreset(const juce::File& file, const juce::StringArray& tags = {});
     void loadPreset(const juce::File& file);
 
+    // Applies a library entry from its indexed values, without reading the
+    // file. As with the file, parameters the preset does not set are left alone.
+    void loadPreset(const PresetLibrary::Entry& entry);
+
+    // The user's preset folder, created and scanned on first use (message thread)
+    PresetLibrary& getPresetLibrary();
+    static juce::File getDefaultPresetDirectory();
+
+    // Parameters that set how the plugin runs (engine, transport, A/B, the
+    // mode selector) rather than how it sounds; preset similarity skips them
+    static juce::StringArray getNonSoundParameterIDs();
+
+    // Sample-accurate automation: sets parameterID to normalisedValue
+    // sampleOffset samples into the next processBlock, splitting the block
+    // there. Call from one thread at a time, normally the one that calls
+    // processBlock. Returns false for an unknown ID or a full queue.
+    //
+    // The change reaches the DSP but is not sent to parameter listeners: the
+    // host is not told, and the APVTS state tree and attached controls do not
+    // follow. Meant for offline renders (see OfflineRenderer::Job::automation).
+    bool postParameterChange(const juce::String& parameterID, float normalisedValue, int sampleOffset);
+
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     ReverbProcessor reverbProcessor;
+    ParameterEventQueue parameterEvents;
+    juce::AudioBuffer<float> sidechainCopy; // key for mono-in/stereo-out, see processBlock
+    std::unique_ptr<PresetLibrary> presetLibrary;
+
+    ReverbParameters readParameters() const;
+
+    // Transport tracking
+    bool wasPlaying = false;
 
 public:
     // Trigger Clear
@@ -0,0 +1,337 @@
+#include "PresetLibrary.h"
+#include <algorithm>
+#include <map>
+
+namespace
+{
+    constexpr int idlePollMs = 250;
+    constexpr int indexVersion = 2;
+
+    void finishEntry(PresetLibrary::Entry& entry)
+    {
+        entry.searchText = (entry.name + " " + entry.tags.joinIntoString(" ")).toLowerCase();
+    }
+
+    juce::StringArray readTags(const juce::var& tags)
+    {
+        juce::StringArray result;
+
+        if (auto* array = tags.getArray())
+            for (auto& tag : *array)
+                if (tag.toString().isNotEmpty())
+                    result.add(tag.toString());
+
+        return result;
+    }
+
+    juce::var toVarArray(const juce::StringArray& strings)
+    {
+        juce::Array<juce::var> array;
+        for (auto& s : strings)
+            array.add(s);
+        return array;
+    }
+}
+
+//==============================================================================
+PresetLibrary::ParameterSpace PresetLibrary::ParameterSpace::fromProcessor(const juce::AudioProcessor& processor,
+                                                                          const juce::StringArray& notSoundShaping)
+{
+    ParameterSpace space;
+
+    for (auto* parameter : processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            space.ids.add(ranged->getParameterID());
+            space.ranges.add(ranged->getNormalisableRange());
+            space.defaults.push_back(ranged->getDefaultValue());
+            space.shapesSound.push_back(! notSoundShaping.contains(ranged->getParameterID()));
+        }
+    }
+
+    return space;
+}
+
+std::vector<float> PresetLibrary::ParameterSpace::makeVector(const juce::var& parameters, std::vector<bool>* stored) const
+{
+    std::vector<float> values = defaults;
+
+    if (stored != nullptr)
+        stored->assign(defaults.size(), false);
+
+    if (auto* object = parameters.getDynamicObject())
+    {
+        for (int i = 0; i < size(); ++i)
+        {
+            const auto& value = object->getProperty(ids[i]);
+            if (value.isVoid())
+                continue;
+
+            values[(size_t)i] = ranges.getReference(i).convertTo0to1(
+                ranges.getReference(i).snapToLegalValue((float)value));
+
+            if (stored != nullptr)
+                (*stored)[(size_t)i] = true;
+        }
+    }
+
+    return values;
+}
+
+std::vector<float> PresetLibrary::ParameterSpace::makeVector(const juce::AudioProcessor& processor) const
+{
+    std::vector<float> values = defaults;
+
+    for (auto* parameter : processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            const int index = ids.indexOf(ranged->getParameterID());
+            if (index >= 0)
+                values[(size_t)index] = ranged->getValue();
+        }
+
+    return values;
+}
+
+//==============================================================================
+PresetLibrary::PresetLibrary(const juce::File& libraryDirectory, ParameterSpace parameterSpace)
+    : directory(libraryDirectory), space(std::move(parameterSpace)), snapshot(std::make_shared<const Snapshot>())
+{
+    scanThread->addTimeSliceClient(this);
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    // Waits for a scan in progress
+    scanThread->removeTimeSliceClient(this);
+}
+
+void PresetLibrary::rescan()
+{
+    scanRequested = true;
+    scanThread->moveToFrontOfQueue(this);
+}
+
+std::shared_ptr<const PresetLibrary::Snapshot> PresetLibrary::getSnapshot() const
+{
+    const juce::ScopedLock sl(snapshotLock);
+    return snapshot;
+}
+
+int PresetLibrary::useTimeSlice()
+{
+    if (scanRequested.exchange(false))
+        scan();
+
+    return idlePollMs;
+}
+
+void PresetLibrary::scan()
+{
+    directory.createDirectory();
+
+    // Index entries by file name; whatever is left over afterwards was deleted
+    std::map<juce::String, Entry> cached;
+    for (auto& entry : readIndex())
+        cached[entry.file.getFileName()] = std::move(entry);
+
+    Snapshot entries;
+    bool changed = false;
+
+    for (auto& file : directory.findChildFiles(juce::File::findFiles, false, "*.json"))
+    {
+        const auto fileSize = file.getSize();
+        const auto modifiedMs = file.getLastModificationTime().toMilliseconds();
+
+        auto it = cached.find(file.getFileName());
+        if (it != cached.end() && it->second.fileSize == fileSize && it->second.modifiedMs == modifiedMs)
+        {
+            entries.push_back(std::move(it->second));
+            cached.erase(it);
+            continue;
+        }
+
+        if (it != cached.end())
+            cached.erase(it);
+
+        Entry entry;
+        entry.file = file;
+        entry.fileSize = fileSize;
+        entry.modifiedMs = modifiedMs;
+
+        // Unreadable files are left out of the index and retried next scan
+        if (parsePreset(file, entry))
+            entries.push_back(std::move(entry));
+
+        changed = true;
+    }
+
+    changed = changed || ! cached.empty();
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.name.compareNatural(b.name) < 0;
+    });
+
+    if (changed)
+        writeIndex(entries);
+
+    {
+        const juce::ScopedLock sl(snapshotLock);
+        snapshot = std::make_shared<const Snapshot>(std::move(entries));
+    }
+
+    scanned = true;
+    sendChangeMessage();
+}
+
+bool PresetLibrary::parsePreset(const juce::File& file, Entry& entry) const
+{
+    const auto json = juce::JSON::parse(file.loadFileAsString());
+    const auto& parameters = json.getProperty("parameters", {});
+
+    if (parameters.getDynamicObject() == nullptr)
+        return false;
+
+    entry.name = json.getProperty("name", file.getFileNameWithoutExtension()).toString();
+    entry.tags = readTags(json.getProperty("tags", {}));
+    entry.values = space.makeVector(parameters, &entry.stored);
+    finishEntry(entry);
+    return true;
+}
+
+std::vector<PresetLibrary::Entry> PresetLibrary::readIndex() const
+{
+    std::vector<Entry> entries;
+    const auto json = juce::JSON::parse(directory.getChildFile(indexFileName).loadFileAsString());
+
+    if ((int)json.getProperty("version", 0) != indexVersion)
+        return entries; // Missing or from another version: everything is parsed again
+
+    // Vectors are stored in the parameter order of the build that wrote the
+    // index; map them onto this one (new parameters take their defaults)
+    std::vector<int> storedIndex;
+    if (auto* storedIds = json.getProperty("parameters", {}).getArray())
+        for (auto& id : space.ids)
+            storedIndex.push_back(storedIds->indexOf(id));
+
+    if (auto* presets = json.getProperty("presets", {}).getArray())
+    {
+        for (auto& preset : *presets)
+        {
+            Entry entry;
+            entry.file = directory.getChildFile(preset.getProperty("file", {}).toString());
+            entry.name = preset.getProperty("name", {}).toString();
+            entry.tags = readTags(preset.getProperty("tags", {}));
+            entry.fileSize = (juce::int64)preset.getProperty("size", 0);
+            entry.modifiedMs = (juce::int64)preset.getProperty("modified", 0);
+            entry.values = space.defaults;
+            entry.stored.assign(space.defaults.size(), false);
+
+            // Values the preset does not set are stored as null
+            if (auto* values = preset.getProperty("values", {}).getArray())
+                for (size_t i = 0; i < storedIndex.size(); ++i)
+                    if (juce::isPositiveAndBelow(storedIndex[i], values->size())
+                        && ! values->getReference(storedIndex[i]).isVoid())
+                    {
+                        entry.values[i] = (float)values->getReference(storedIndex[i]);
+                        entry.stored[i] = true;
+                    }
+
+            finishEntry(entry);
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    return entries;
+}
+
+void PresetLibrary::writeIndex(const Snapshot& entries) const
+{
+    juce::Array<juce::var> presets;
+
+    for (auto& entry : entries)
+    {
+        juce::Array<juce::var> values;
+        for (size_t i = 0; i < entry.values.size(); ++i)
+            values.add(i < entry.stored.size() && entry.stored[i] ? juce::var(entry.values[i]) : juce::var());
+
+        auto* object = new juce::DynamicObject();
+        object->setProperty("file", entry.file.getFileName());
+        object->setProperty("name", entry.name);
+        object->setProperty("tags", toVarArray(entry.tags));
+        object->setProperty("size", entry.fileSize);
+        object->setProperty("modified", entry.modifiedMs);
+        object->setProperty("values", values);
+        presets.add(juce::var(object));
+    }
+
+    auto* index = new juce::DynamicObject();
+    index->setProperty("version", indexVersion);
+    index->setProperty("parameters", toVarArray(space.ids));
+    index->setProperty("presets", presets);
+
+    // Written to a temporary file first, so a crash never leaves half an index
+    juce::TemporaryFile temp(directory.getChildFile(indexFileName));
+    if (temp.getFile().replaceWithText(juce::JSON::toString(juce::var(index), true)))
+        temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+std::vector<const PresetLibrary::Entry*> PresetLibrary::search(const Snapshot& snapshot, const juce::String& query)
+{
+    const auto words = juce::StringArray::fromTokens(query.toLowerCase(), true);
+    std::vector<const Entry*> results;
+
+    for (auto& entry : snapshot)
+    {
+        bool matches = true;
+        for (auto& word : words)
+            if (word.isNotEmpty() && ! entry.searchText.contains(word))
+            {
+                matches = false;
+                break;
+            }
+
+        if (matches)
+            results.push_back(&entry);
+    }
+
+    return results;
+}
+
+std::vector<const PresetLibrary::Entry*> PresetLibrary::findSimilar(const Snapshot& snapshot, const ParameterSpace& space,
+                                                                   const std::vector<float>& point, int maxResults,
+                                                                   const Entry* exclude)
+{
+    std::vector<std::pair<float, const Entry*>> scored;
+    scored.reserve(snapshot.size());
+
+    for (auto& entry : snapshot)
+    {
+        if (&entry == exclude || entry.values.size() != point.size() || point.size() != space.shapesSound.size())
+            continue;
+
+        float distance = 0.0f;
+        for (size_t i = 0; i < point.size(); ++i)
+        {
+            if (! space.shapesSound[i])
+                continue;
+
+            const float d = entry.values[i] - point[i];
+            distance += d * d;
+        }
+
+        scored.emplace_back(distance, &entry);
+    }
+
+    const auto count = (size_t)juce::jlimit(0, (int)scored.size(), maxResults);
+    std::partial_sort(scored.begin(), scored.begin() + (std::ptrdiff_t)count, scored.end(),
+                      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<const Entry*> results;
+    for (size_t i = 0; i < count; ++i)
+        results.push_back(scored[i].second);
+
+    return results;
+}
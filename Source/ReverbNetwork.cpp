@@ -0,0 +1,542 @@
+#include "ReverbNetwork.h"
+#include "DelayArena.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    // Freeverb tunings at 44.1 kHz. The first four are an evenly spread subset
+    // for the reduced topology, the first eight are juce::Reverb's set, and the
+    // last four are the extra combs of the dense topology.
+    constexpr int combTunings[] = { 1116, 1277, 1422, 1557, 1188, 1356, 1491, 1617,
+                                    1051, 1213, 1319, 1453 };
+    constexpr int allPassTunings[] = { 556, 441, 341, 225 };
+    constexpr int stereoSpread = 23;
+
+    static_assert(std::size(combTunings) == ReverbNetwork::maxCombs, "one tuning per comb");
+    static_assert(ModulationBank::maxVoices >= 2 * ReverbNetwork::maxCombs, "one voice per comb and channel");
+
+    int delayLength(int tuning, int channel, int intSampleRate)
+    {
+        return (intSampleRate * (tuning + channel * stereoSpread)) / 44100;
+    }
+}
+
+ReverbNetwork::ReverbNetwork()
+{
+    setParameters(Parameters());
+}
+
+void ReverbNetwork::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    activeChannels = juce::jlimit(1, numChannels, (int)spec.numChannels);
+
+    // Sized for the largest topology at the full rate; setTopology() only
+    // ever lays out less than this.
+    const int intSampleRate = (int)spec.sampleRate;
+    memorySize = 0;
+
+    for (int ch = 0; ch < activeChannels; ++ch)
+    {
+        for (int tuning : combTunings)
+            memorySize += DelayArena::alignedSize((size_t)delayLength(tuning, ch, intSampleRate));
+
+        for (int tuning : allPassTunings)
+            memorySize += DelayArena::alignedSize((size_t)delayLength(tuning, ch, intSampleRate));
+    }
+
+    memory = nullptr;
+    clearPos = memorySize;
+
+    resampler.prepare((int)spec.maximumBlockSize);
+
+    updateCrossovers();
+    resetSmoothers();
+}
+
+size_t ReverbNetwork::getRequiredStorage() const
+{
+    return memorySize;
+}
+
+void ReverbNetwork::setStorage(float* storage)
+{
+    memory = storage;
+    layoutBuffers();
+    reset();
+}
+
+void ReverbNetwork::setTopology(int newNumCombs, int newRateDivisor)
+{
+    const int combs = juce::jlimit(1, maxCombs, newNumCombs);
+    combGain = std::sqrt((float)standardCombs / (float)combs);
+
+    if (memory != nullptr && HalfbandResampler::toFactor(newRateDivisor) == rateDivisor)
+    {
+        setCombCount(combs);
+        return;
+    }
+
+    numCombs = runningCombs = combs;
+    resampler.setFactor(newRateDivisor);
+    rateDivisor = resampler.getFactor();
+
+    if (memory != nullptr)
+        layoutBuffers();
+
+    updateCrossovers();
+    resetSmoothers();
+}
+
+void ReverbNetwork::setCombCount(int combs)
+{
+    if (combs > numCombs)
+    {
+        // Combs still fading out are taken back as they are; the others have
+        // not run since the last clear or layout and start empty
+        for (int j = runningCombs; j < combs; ++j)
+            for (int ch = 0; ch < activeChannels; ++ch)
+            {
+                juce::FloatVectorOperations::clear(comb[ch][j].buffer, comb[ch][j].size);
+                comb[ch][j].index = 0;
+                loop[ch].damped[j] = loop[ch].lowBand[j] = loop[ch].belowHigh[j] = 0.0f;
+            }
+
+        numCombs = combs;
+        runningCombs = juce::jmax(runningCombs, combs);
+    }
+    else if (combs < numCombs)
+    {
+        // The dropped combs keep running while what is written into them
+        // ramps to zero over one comb length, then play that out once more
+        int longest = 0;
+        for (int j = combs; j < runningCombs; ++j)
+            longest = juce::jmax(longest, comb[activeChannels - 1][j].size);
+
+        retireGain.reset(longest);
+        retireGain.setCurrentAndTargetValue(1.0f);
+        retireGain.setTargetValue(0.0f);
+        retireSamplesLeft = 2 * longest;
+        numCombs = combs;
+    }
+}
+
+void ReverbNetwork::layoutBuffers()
+{
+    const int intSampleRate = (int)(sampleRate / rateDivisor);
+    float* next = memory;
+    int shortestComb = std::numeric_limits<int>::max();
+
+    // Visit order of the sample loop: comb j of every channel, then allpass j.
+    // Every comb has its slot whether it runs or not, so a change of comb
+    // count leaves the others where they are.
+    for (int i = 0; i < maxCombs; ++i)
+        for (int ch = 0; ch < activeChannels; ++ch)
+        {
+            comb[ch][i] = { next, delayLength(combTunings[i], ch, intSampleRate), 0 };
+            next += DelayArena::alignedSize((size_t)comb[ch][i].size);
+            shortestComb = juce::jmin(shortestComb, comb[ch][i].size);
+        }
+
+    for (int i = 0; i < numAllPasses; ++i)
+        for (int ch = 0; ch < activeChannels; ++ch)
+        {
+            allPass[ch][i] = { next, delayLength(allPassTunings[i], ch, intSampleRate), 0 };
+            next += DelayArena::alignedSize((size_t)allPass[ch][i].size);
+        }
+
+    jassert(next <= memory + memorySize);
+    maxShorten = (float)(shortestComb - 2);
+}
+
+void ReverbNetwork::resetSmoothers()
+{
+    const double networkRate = sampleRate / rateDivisor;
+    const double smoothTime = 0.01;
+    damping.reset(networkRate, smoothTime);
+    lowFeedback.reset(networkRate, smoothTime);
+    feedback.reset(networkRate, smoothTime);
+    highFeedback.reset(networkRate, smoothTime);
+    dryGain.reset(networkRate, smoothTime);
+    wetGain1.reset(networkRate, smoothTime);
+    wetGain2.reset(networkRate, smoothTime);
+}
+
+void ReverbNetwork::reset()
+{
+    beginClear();
+    clearNextChunk(memorySize);
+}
+
+void ReverbNetwork::beginClear()
+{
+    clearPos = 0;
+    runningCombs = numCombs;
+
+    for (auto& state : loop)
+        state = {};
+
+    resampler.reset();
+}
+
+void ReverbNetwork::clearNextChunk(size_t maxSamples)
+{
+    const size_t count = std::min(maxSamples, memorySize - clearPos);
+    if (count > 0)
+        juce::FloatVectorOperations::clear(memory + clearPos, (int)count);
+    clearPos += count;
+}
+
+void ReverbNetwork::setParameters(const Parameters& newParams)
+{
+    const float wetScaleFactor = 3.0f;
+    const float dryScaleFactor = 2.0f;
+
+    const float wet = newParams.wetLevel * wetScaleFactor;
+    dryGain.setTargetValue(newParams.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue(0.5f * wet * (1.0f + newParams.width));
+    wetGain2.setTargetValue(0.5f * wet * (1.0f - newParams.width));
+
+    gain = isFrozen(newParams.freezeMode) ? 0.0f : 0.015f;
+    parameters = newParams;
+    updateDamping();
+}
+
+void ReverbNetwork::setDecayShape(const DecayShape& newShape)
+{
+    if (newShape == decayShape)
+        return;
+
+    decayShape = newShape;
+    updateCrossovers();
+    updateDamping();
+}
+
+void ReverbNetwork::updateCrossovers() noexcept
+{
+    // One-pole lowpasses at the band edges, kept below the network's Nyquist
+    const double networkRate = sampleRate / rateDivisor;
+    auto coefficient = [networkRate](float hz) {
+        const double fc = juce::jmin((double)hz, 0.45 * networkRate);
+        return (float)(1.0 - std::exp(-juce::MathConstants<double>::twoPi * fc / networkRate));
+    };
+
+    lowCrossoverCoeff = coefficient(decayShape.lowCrossover);
+    highCrossoverCoeff = coefficient(decayShape.highCrossover);
+}
+
+void ReverbNetwork::setModulation(const ModulationBank* bank, float depthSeconds)
+{
+    modulation = bank;
+    modulationDepthSeconds = bank != nullptr ? juce::jmax(0.0f, depthSeconds) : 0.0f;
+}
+
+void ReverbNetwork::updateDamping() noexcept
+{
+    const float roomScaleFactor = 0.28f;
+    const float roomOffset = 0.7f;
+    const float dampScaleFactor = 0.4f;
+
+    float loopGain = 1.0f;
+
+    if (isFrozen(parameters.freezeMode))
+    {
+        damping.setTargetValue(0.0f);
+    }
+    else
+    {
+        damping.setTargetValue(parameters.damping * dampScaleFactor);
+        loopGain = parameters.roomSize * roomScaleFactor + roomOffset;
+    }
+
+    // Scaling a band's RT60 by m scales the log of its loop gain by 1/m.
+    // Frozen, every band stays at unity.
+    auto bandGain = [loopGain](float rt60Multiplier) {
+        return std::pow(loopGain, 1.0f / juce::jmax(0.01f, rt60Multiplier));
+    };
+
+    lowFeedback.setTargetValue(bandGain(decayShape.low));
+    feedback.setTargetValue(bandGain(decayShape.mid));
+    highFeedback.setTargetValue(bandGain(decayShape.high));
+}
+
+void ReverbNetwork::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    auto& block = context.getOutputBlock();
+    const int numSamples = (int)block.getNumSamples();
+
+    if (isClearing())
+    {
+        block.clear();
+        return;
+    }
+
+    if (rateDivisor > 1)
+        processReducedRate(block);
+    else if (block.getNumChannels() == 1 || activeChannels == 1)
+        processNetwork(block.getChannelPointer(0), nullptr, numSamples);
+    else if (block.getNumChannels() == 2)
+        processNetwork(block.getChannelPointer(0), block.getChannelPointer(1), numSamples);
+    else
+        jassertfalse;
+}
+
+bool ReverbNetwork::isShaped() const noexcept
+{
+    // Also while a band gain is still gliding towards the mid gain
+    return lowFeedback.getTargetValue() != feedback.getTargetValue() || highFeedback.getTargetValue() != feedback.getTargetValue()
+        || lowFeedback.isSmoothing() || highFeedback.isSmoothing();
+}
+
+void ReverbNetwork::processNetwork(float* left, float* right, int numSamples) noexcept
+{
+    const bool modulated = modulationDepthSeconds > 0.0f;
+    const bool shaped = isShaped();
+
+    // The crossovers did not run while the decay was flat; start them on the
+    // current loop signal rather than on stale values
+    if (shaped && ! wasShaped)
+        for (auto& state : loop)
+            for (int j = 0; j < maxCombs; ++j)
+                state.lowBand[j] = state.belowHigh[j] = state.damped[j];
+
+    wasShaped = shaped;
+
+    if (modulated) shaped ? runNetwork<true, true>(left, right, numSamples) : runNetwork<true, false>(left, right, numSamples);
+    else           shaped ? runNetwork<false, true>(left, right, numSamples) : runNetwork<false, false>(left, right, numSamples);
+
+    if (runningCombs > numCombs && (retireSamplesLeft -= numSamples) <= 0)
+        runningCombs = numCombs; // The dropped combs are silent now
+}
+
+template <bool modulated, bool shaped>
+void ReverbNetwork::runNetwork(float* left, float* right, int numSamples) noexcept
+{
+    if (right == nullptr)
+        processMono<modulated, shaped, false>(left, nullptr, numSamples);
+    else if (monoSource)
+        processMono<modulated, shaped, true>(left, right, numSamples);
+    else
+        processStereo<modulated, shaped>(left, right, numSamples);
+}
+
+template <bool shaped>
+ReverbNetwork::LoopGains ReverbNetwork::nextLoopGains() noexcept
+{
+    const float mid = feedback.getNextValue();
+
+    if constexpr (shaped)
+        return { lowFeedback.getNextValue(), mid, highFeedback.getNextValue() };
+    else
+        return { mid, mid, mid };
+}
+
+template <bool shaped>
+void ReverbNetwork::filterLoop(LoopState& state, const float* taps, float* feedbackOut, float damp, LoopGains gains) const noexcept
+{
+    // Independent lanes: no dependency between combs, so this vectorises
+    for (int j = 0; j < runningCombs; ++j)
+    {
+        float damped = (taps[j] * (1.0f - damp)) + (state.damped[j] * damp);
+        JUCE_UNDENORMALISE (damped);
+        state.damped[j] = damped;
+
+        if constexpr (shaped)
+        {
+            // low + mid + high == damped; each band weighted by its own gain
+            float low = state.lowBand[j] + (damped - state.lowBand[j]) * lowCrossoverCoeff;
+            float belowHigh = state.belowHigh[j] + (damped - state.belowHigh[j]) * highCrossoverCoeff;
+            JUCE_UNDENORMALISE (low);
+            JUCE_UNDENORMALISE (belowHigh);
+            state.lowBand[j] = low;
+            state.belowHigh[j] = belowHigh;
+
+            feedbackOut[j] = gains.mid * damped + (gains.low - gains.mid) * low + (gains.high - gains.mid) * (damped - belowHigh);
+        }
+        else
+        {
+            feedbackOut[j] = damped * gains.mid;
+        }
+    }
+}
+
+void ReverbNetwork::updateModulation(int start, int length, int channels,
+                                     float (&shorten)[2][maxCombs], float (&step)[2][maxCombs]) const noexcept
+{
+    const double secondsPerSample = rateDivisor / sampleRate;
+    const float depth = juce::jmin(modulationDepthSeconds * (float)(sampleRate / rateDivisor), 0.5f * maxShorten);
+
+    for (int ch = 0; ch < channels; ++ch)
+        for (int j = 0; j < runningCombs; ++j)
+        {
+            const int voice = ch * maxCombs + j;
+            const float from = depth * (1.0f + modulation->getValue(voice, start * secondsPerSample));
+            const float to = depth * (1.0f + modulation->getValue(voice, (start + length) * secondsPerSample));
+            shorten[ch][j] = from;
+            step[ch][j] = (to - from) / (float)length;
+        }
+}
+
+void ReverbNetwork::processReducedRate(const juce::dsp::AudioBlock<float>& block) noexcept
+{
+    const int channels = (block.getNumChannels() == 1 || activeChannels == 1) ? 1 : 2;
+    const int numReduced = resampler.downsample(block, monoSource ? 1 : channels); // A mono source only needs channel 0
+
+    processNetwork(resampler.getReducedChannel(0), channels == 1 ? nullptr : resampler.getReducedChannel(1), numReduced);
+
+    resampler.upsample(block, channels, numReduced);
+}
+
+template <bool modulated, bool shaped>
+void ReverbNetwork::processStereo(float* left, float* right, int numSamples) noexcept
+{
+    const float inputGain = gain * combGain;
+    float shorten[2][maxCombs] = {}, step[2][maxCombs] = {};
+    float taps[2][maxCombs], feedbackIn[2][maxCombs];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if constexpr (modulated)
+            if (i % modulationInterval == 0)
+                updateModulation(i, juce::jmin(modulationInterval, numSamples - i), 2, shorten, step);
+
+        const float input = (left[i] + right[i]) * inputGain;
+        float outL = 0, outR = 0;
+
+        const float damp = damping.getNextValue();
+        const LoopGains gains = nextLoopGains<shaped>();
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int j = 0; j < runningCombs; ++j)
+            {
+                if constexpr (modulated)
+                {
+                    taps[ch][j] = comb[ch][j].readModulated(shorten[ch][j]);
+                    shorten[ch][j] += step[ch][j];
+                }
+                else
+                {
+                    taps[ch][j] = comb[ch][j].read();
+                }
+            }
+
+        filterLoop<shaped>(loop[0], taps[0], feedbackIn[0], damp, gains);
+        filterLoop<shaped>(loop[1], taps[1], feedbackIn[1], damp, gains);
+
+        for (int j = 0; j < numCombs; ++j) // accumulate the comb filters in parallel
+        {
+            comb[0][j].write(input + feedbackIn[0][j]);
+            comb[1][j].write(input + feedbackIn[1][j]);
+            outL += taps[0][j];
+            outR += taps[1][j];
+        }
+
+        if (runningCombs > numCombs) // dropped combs fading out
+        {
+            const float retire = retireGain.getNextValue();
+            for (int j = numCombs; j < runningCombs; ++j)
+            {
+                comb[0][j].write((input + feedbackIn[0][j]) * retire);
+                comb[1][j].write((input + feedbackIn[1][j]) * retire);
+                outL += taps[0][j];
+                outR += taps[1][j];
+            }
+        }
+
+        for (int j = 0; j < numAllPasses; ++j) // run the allpass filters in series
+        {
+            outL = allPass[0][j].process(outL);
+            outR = allPass[1][j].process(outR);
+        }
+
+        const float dry = dryGain.getNextValue();
+        const float wet1 = wetGain1.getNextValue();
+        const float wet2 = wetGain2.getNextValue();
+
+        left[i] = outL * wet1 + outR * wet2 + left[i] * dry;
+        right[i] = outR * wet1 + outL * wet2 + right[i] * dry;
+    }
+}
+
+template <bool modulated, bool shaped, bool stereoOut>
+void ReverbNetwork::processMono(float* left, float* right, int numSamples) noexcept
+{
+    // Fed to a stereo output, the input counts twice, as in the stereo core
+    // fed the same signal on both channels
+    const float inputGain = gain * combGain * (stereoOut ? 2.0f : 1.0f);
+    float shorten[2][maxCombs] = {}, step[2][maxCombs] = {};
+    float taps[maxCombs], feedbackIn[maxCombs];
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if constexpr (modulated)
+            if (i % modulationInterval == 0)
+                updateModulation(i, juce::jmin(modulationInterval, numSamples - i), 1, shorten, step);
+
+        const float input = left[i] * inputGain;
+        float output = 0, alternating = 0;
+
+        const float damp = damping.getNextValue();
+        const LoopGains gains = nextLoopGains<shaped>();
+
+        for (int j = 0; j < runningCombs; ++j)
+        {
+            if constexpr (modulated)
+            {
+                taps[j] = comb[0][j].readModulated(shorten[0][j]);
+                shorten[0][j] += step[0][j];
+            }
+            else
+            {
+                taps[j] = comb[0][j].read();
+            }
+        }
+
+        filterLoop<shaped>(loop[0], taps, feedbackIn, damp, gains);
+
+        for (int j = 0; j < numCombs; ++j)
+        {
+            comb[0][j].write(input + feedbackIn[j]);
+            output += taps[j];
+
+            if constexpr (stereoOut)
+                alternating += (j & 1) ? -taps[j] : taps[j];
+        }
+
+        if (runningCombs > numCombs) // dropped combs fading out
+        {
+            const float retire = retireGain.getNextValue();
+            for (int j = numCombs; j < runningCombs; ++j)
+            {
+                comb[0][j].write((input + feedbackIn[j]) * retire);
+                output += taps[j];
+
+                if constexpr (stereoOut)
+                    alternating += (j & 1) ? -taps[j] : taps[j];
+            }
+        }
+
+        for (int j = 0; j < numAllPasses; ++j)
+            output = allPass[0][j].process(output);
+
+        const float dry = dryGain.getNextValue();
+        const float wet1 = wetGain1.getNextValue();
+
+        if constexpr (stereoOut)
+        {
+            for (int j = 0; j < numAllPasses; ++j)
+                alternating = allPass[1][j].process(alternating);
+
+            const float wet2 = wetGain2.getNextValue();
+            const float in = left[i];
+
+            left[i] = output * wet1 + alternating * wet2 + in * dry;
+            right[i] = alternating * wet1 + output * wet2 + in * dry;
+        }
+        else
+        {
+            left[i] = output * wet1 + left[i] * dry;
+        }
+    }
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "HalfbandResampler.h"
+#include "ModulationBank.h"
+
+// Freeverb-style network (8 parallel damped combs into 4 series allpasses per
+// channel). The algorithm and tunings match juce::Reverb; the difference is
+// that all comb and allpass memory lives in one block of the owner's
+// DelayArena, so the network can be cleared a chunk at a time instead of in a
+// single callback. Buffers are laid out in the order the sample loop visits
+// them (comb L/R pairs, then allpass L/R pairs), and only for the prepared
+// channel count.
+//
+// The topology can be scaled down or up at runtime (setTopology): 4 to 12
+// combs, and the whole network run at 1/2 or 1/4 of the host rate behind
+// halfband resamplers. Storage is always sized for the largest topology at
+// the full rate, so switching never allocates.
+//
+// The comb read taps can be swept by a ModulationBank (setModulation), one
+// voice per comb and channel. With no depth the unmodulated loop runs and the
+// bank is never consulted.
+//
+// The decay can be shaped per band (setDecayShape): the comb feedback is
+// split by two one-pole crossovers and each band gets its own loop gain, so
+// low, mid and high frequencies die away at their own RT60. The loop filters
+// of all combs run as one pass over struct-of-arrays state, which vectorises
+// across the delay lines. With a flat shape only the damping filter runs.
+//
+// A mono source (setMonoSource) runs one channel of combs even when the
+// output is stereo: the right output is the same combs summed with
+// alternating signs, which is uncorrelated with the plain sum, and each side
+// then goes through its own allpass chain.
+class ReverbNetwork
+{
+public:
+    using Parameters = juce::Reverb::Parameters;
+
+    // RT60 of each band relative to the unshaped decay, and the band edges
+    struct DecayShape
+    {
+        float low = 1.0f;
+        float mid = 1.0f;
+        float high = 1.0f;
+        float lowCrossover = 250.0f;   // Hz
+        float highCrossover = 4000.0f; // Hz
+
+        bool operator==(const DecayShape& other) const noexcept
+        {
+            return low == other.low && mid == other.mid && high == other.high
+                && lowCrossover == other.lowCrossover && highCrossover == other.highCrossover;
+        }
+    };
+
+    static constexpr int maxCombs = 12;
+    static constexpr int standardCombs = 8; // juce::Reverb
+    static constexpr int maxRateDivisor = HalfbandResampler::maxFactor;
+
+    ReverbNetwork();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    size_t getRequiredStorage() const;
+    void setStorage(float* storage);
+    void reset();
+
+    void setParameters(const Parameters& newParams);
+    void setDecayShape(const DecayShape& newShape);
+
+    // True when only channel 0 of the block carries input. A stereo block
+    // then gets the single-channel core with a derived right output.
+    void setMonoSource(bool isMono) { monoSource = isMono; }
+
+    // Each comb's delay sweeps between its nominal length and 2 * depthSeconds
+    // shorter. The bank must stay valid while depthSeconds > 0.
+    void setModulation(const ModulationBank* bank, float depthSeconds);
+
+    // Selects how many combs run and the rate divisor (1, 2 or 4).
+    //
+    // A change of comb count alone keeps the tail: added combs start empty
+    // and fill from the input, dropped combs fade out over two of their
+    // lengths. Safe to call from the audio thread at any time.
+    //
+    // A change of rate re-lays out the delay lines, so the contents are
+    // garbage afterwards: mute the output and call beginClear() or reset()
+    // before using it. At a reduced rate the dry component is band-limited
+    // along with the wet.
+    void setTopology(int numCombs, int rateDivisor);
+
+    // Incremental clear. While clearing, process() outputs silence and skips
+    // the network entirely; call clearNextChunk() once per block until done.
+    void beginClear();
+    void clearNextChunk(size_t maxSamples);
+    bool isClearing() const { return clearPos < memorySize; }
+
+    // Delay added by the rate conversion at the current topology, in host samples.
+    int getLatencyInSamples() const { return rateDivisor > 1 ? resampler.getLatencyInSamples() : 0; }
+
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+
+private:
+    static constexpr int numAllPasses = 4;
+    static constexpr int numChannels = 2;
+
+    // The delay line of one comb; its loop filter runs in filterLoop()
+    struct CombFilter
+    {
+        float* buffer = nullptr;
+        int size = 0;
+        int index = 0;
+
+        float read() const noexcept { return buffer[index]; }
+
+        // Reads 'shorten' samples ahead of the write position, i.e. that many
+        // samples less delay, interpolating linearly.
+        float readModulated(float shorten) const noexcept
+        {
+            const int whole = (int)shorten;
+            const float frac = shorten - (float)whole;
+            int i0 = index + whole;
+            if (i0 >= size) i0 -= size;
+            const int i1 = i0 + 1 < size ? i0 + 1 : 0;
+
+            return buffer[i0] + frac * (buffer[i1] - buffer[i0]);
+        }
+
+        void write(float value) noexcept
+        {
+            JUCE_UNDENORMALISE (value);
+            buffer[index] = value;
+            if (++index >= size) index = 0;
+        }
+    };
+
+    // Loop filter state of every comb of one channel, one lane per comb
+    struct LoopState
+    {
+        float damped[maxCombs] = {};    // damping lowpass output (Freeverb's 'last')
+        float lowBand[maxCombs] = {};   // lowpass at the low crossover
+        float belowHigh[maxCombs] = {}; // lowpass at the high crossover
+    };
+
+    struct LoopGains
+    {
+        float low, mid, high;
+    };
+
+    struct AllPassFilter
+    {
+        float* buffer = nullptr;
+        int size = 0;
+        int index = 0;
+
+        float process(float input) noexcept
+        {
+            const float bufferedValue = buffer[index];
+            float temp = input + (bufferedValue * 0.5f);
+            JUCE_UNDENORMALISE (temp);
+            buffer[index] = temp;
+            if (++index >= size) index = 0;
+            return bufferedValue - input;
+        }
+    };
+
+    void processNetwork(float* left, float* right, int numSamples) noexcept; // right == nullptr for mono
+    template <bool modulated, bool shaped> void processStereo(float* left, float* right, int numSamples) noexcept;
+    template <bool modulated, bool shaped> void runNetwork(float* left, float* right, int numSamples) noexcept;
+    // One channel of combs; with stereoOut the right output is derived from them
+    template <bool modulated, bool shaped, bool stereoOut> void processMono(float* left, float* right, int numSamples) noexcept;
+
+    // Damps (and with 'shaped', splits and weights) the comb outputs 'taps',
+    // writing the signal fed back into each comb to 'feedbackOut'
+    template <bool shaped>
+    void filterLoop(LoopState& state, const float* taps, float* feedbackOut, float damp, LoopGains gains) const noexcept;
+    template <bool shaped> LoopGains nextLoopGains() noexcept;
+    bool isShaped() const noexcept;
+    void updateCrossovers() noexcept;
+
+    // Sweep of every comb over the next 'length' network samples, as a start
+    // value and a per-sample step
+    void updateModulation(int start, int length, int channels,
+                          float (&shorten)[2][maxCombs], float (&step)[2][maxCombs]) const noexcept;
+    void processReducedRate(const juce::dsp::AudioBlock<float>& block) noexcept;
+    void updateDamping() noexcept;
+    void setCombCount(int combs);
+    void layoutBuffers();
+    void resetSmoothers();
+
+    static bool isFrozen(float freezeMode) noexcept { return freezeMode >= 0.5f; }
+
+    Parameters parameters;
+    float gain = 0.015f;
+    float combGain = 1.0f; // keeps the level of the comb sum independent of numCombs
+
+    double sampleRate = 44100.0;
+    float* memory = nullptr;
+    size_t memorySize = 0;
+    size_t clearPos = 0;
+    int activeChannels = 0;
+    int numCombs = standardCombs;
+    int runningCombs = standardCombs; // numCombs plus dropped combs still fading out
+    int retireSamplesLeft = 0;        // network samples until the dropped combs are silent
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> retireGain; // input and feedback of the dropped combs
+    int rateDivisor = 1;
+    bool monoSource = false;
+
+    HalfbandResampler resampler;
+
+    static constexpr int modulationInterval = 32; // network samples between LFO evaluations
+    const ModulationBank* modulation = nullptr;
+    float modulationDepthSeconds = 0.0f;
+    float maxShorten = 0.0f; // keeps the swept read tap inside the shortest comb
+
+    CombFilter comb[numChannels][maxCombs];
+    AllPassFilter allPass[numChannels][numAllPasses];
+    LoopState loop[numChannels];
+
+    DecayShape decayShape;
+    float lowCrossoverCoeff = 0.0f, highCrossoverCoeff = 0.0f;
+    bool wasShaped = false;
+
+    // 'feedback' is the loop gain of the mid band, and of the whole loop when unshaped
+    juce::SmoothedValue<float> damping, lowFeedback, feedback, highFeedback, dryGain, wetGain1, wetGain2;
+};
@@ -2,16 +2,23 @@
 #include <cmath>
 #include <juce_audio_basics/juce_audio_basics.h>
 
+namespace
+{
+    // Length in quarter-note beats of each PREDELAY_SYNC choice (index 0 = Free)
+    constexpr float syncBeats[] = {
+        0.0f,
+        1.0f, 0.5f, 0.25f,                                  // 1/4, 1/8, 1/16
+        2.0f,                                               // 1/2
+        3.0f, 1.5f, 0.75f, 0.375f,                          // 1/2., 1/4., 1/8., 1/16.
+        4.0f / 3.0f, 2.0f / 3.0f, 1.0f / 3.0f, 1.0f / 6.0f  // 1/2T, 1/4T, 1/8T, 1/16T
+    };
+}
+
 ReverbProcessor::ReverbProcessor()
 {
-    dynEqFilter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
     detectorFilter.setType(juce::dsp::StateVariableTPTFilterType::bandpass);
 
-    saturator.functionToUse = [](float x) {
-        return std::tanh(x);
-    };
-
-    limiter.setThreshold(0.0f);
+    limiter.setThreshold(-0.1f);
     limiter.setRelease(100.0f);
 }
 
@@ -21,56 +28,324 @@ ReverbProcessor::~ReverbProcessor()
 
 void ReverbProcessor::prepare(const juce::dsp::ProcessSpec& spec)
 {
+    // Hosts re-prepare on transport starts, bypass toggles and session loads.
+    // With an unchanged spec every buffer already has the right size, so only
+    // the state is cleared.
+    if (preparedSpec.has_value() && preparedSpec->sampleRate == spec.sampleRate
+        && preparedSpec->maximumBlockSize == spec.maximumBlockSize && preparedSpec->numChannels == spec.numChannels)
+    {
+        applyEngineSettings();
+        reset();
+        return;
+    }
+
+    preparedSpec = spec;
     sampleRate = spec.sampleRate;
 
-    reverb.prepare(spec);
-    delayLine.prepare(spec);
-    chorus.prepare(spec);
+    // Shared with every other instance running at this rate
+    rateTables = SharedTables::getForSampleRate(sampleRate);
+    shapeTables = SharedTables::getShapes();
 
-    dynEqFilter.prepare(spec);
+    delayLine.prepare(spec);
+    diffuser.prepare(spec);
+    reverb.prepare(spec);
+    linearEq.prepare(spec);
+    dryDelay.prepare(spec, linearEq.getLatencyInSamples());
+    limiter.prepare(spec);
+    applyEngineSettings();
+
+    // All delay memory in one allocation, laid out in signal-chain order
+    const size_t preDelaySize = delayLine.getRequiredStorage();
+    const size_t diffuserSize = diffuser.getRequiredStorage();
+    const size_t networkSize = reverb.getRequiredStorage();
+    const size_t linearEqSize = linearEq.getRequiredStorage();
+    const size_t dryDelaySize = dryDelay.getRequiredStorage();
+    delayArena.allocate(preDelaySize + diffuserSize + networkSize + linearEqSize + dryDelaySize + limiter.getRequiredStorage());
+
+    float* region = delayArena.data();
+    delayLine.setStorage(region);
+    diffuser.setStorage(region += preDelaySize);
+    reverb.setStorage(region += diffuserSize);
+    linearEq.setStorage(region += networkSize);
+    dryDelay.setStorage(region += linearEqSize);
+    limiter.setStorage(region + dryDelaySize);
+
+    modulation.prepare(sampleRate);
+
+    jassert(spec.numChannels <= 2); // The stereo filters carry at most an L/R pair
+    dynEqFilter.prepare(spec.sampleRate);
     detectorFilter.prepare(spec);
 
-    eq3Chain.prepare(spec);
+    eq3.reset();
+    eq3Designed = false;
 
-    limiter.prepare(spec);
-    saturator.prepare(spec);
+    if (saturationOversampler == nullptr)
+        saturationOversampler = std::make_unique<juce::dsp::Oversampling<float>>(2, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, false);
+    saturationOversampler->initProcessing(spec.maximumBlockSize);
 
-    delayLine.setMaximumDelayInSamples(2.0 * sampleRate);
     wetBuffer.setSize(spec.numChannels, spec.maximumBlockSize);
+    detectorBuffer.setSize(3, spec.maximumBlockSize);
+
+    duckFollower.prepare(rateTables->duckAttack, rateTables->duckRelease);
+    stateIsClear = true;
 }
 
 void ReverbProcessor::reset()
 {
     reverb.reset();
     delayLine.reset();
-    chorus.reset();
+    diffuser.reset();
+    modulation.reset();
     dynEqFilter.reset();
     detectorFilter.reset();
-    eq3Chain.reset();
+    eq3.reset();
+    linearEq.reset();
+    dryDelay.reset();
     limiter.reset();
-    saturator.reset();
+    if (saturationOversampler != nullptr)
+        saturationOversampler->reset();
 
     gateEnv = 0.0f;
-    duckEnv = 0.0f;
+    duckFollower.reset();
     dynEqEnv = 0.0f;
+
+    tailGain.setCurrentAndTargetValue(1.0f);
+    tailState = TailState::running;
+    activeStages = 0;
+    wasFrozen = false;
+    stateIsClear = true;
+}
+
+void ReverbProcessor::fadeOutTail(float fadeSeconds)
+{
+    if (tailState == TailState::clearing)
+        return; // Already silent
+
+    if (tailState == TailState::fading && fadeSeconds >= tailFadeSeconds)
+        return; // The running fade is at least as quick
+
+    // A quicker fade (CLEAR during an On Stop fade) takes over from the
+    // current gain at its own rate, so it never jumps
+    const float gain = tailGain.getCurrentValue();
+    tailGain.reset(sampleRate, gain * fadeSeconds);
+    tailGain.setCurrentAndTargetValue(gain);
+    tailGain.setTargetValue(0.0f);
+    tailFadeSeconds = fadeSeconds;
+    tailState = TailState::fading;
+}
+
+void ReverbProcessor::beginTailClear()
+{
+    // The pre-delay is only invalidated; its (large) buffer is never touched.
+    delayLine.flush();
+
+    // A pending quality or rate change re-lays out the network, so apply it
+    // before the clear. The network is zeroed incrementally from the block loop below.
+    if (engineSettingsChanged())
+        applyEngineSettings();
+
+    reverb.beginClear();
+    diffuser.reset(); // A few thousand samples; cleared in one go
+    saturationOversampler->reset();
+
+    dynEqFilter.reset();
+    detectorFilter.reset();
+    eq3.reset();
+    linearEq.reset();
+
+    gateEnv = 0.0f;
+    dynEqEnv = 0.0f;
+}
+
+int ReverbProcessor::getRateDivisor(const ReverbParameters& params)
+{
+    const int chosen = params.reverbRate == 2 ? 4 : (params.reverbRate == 1 ? 2 : 1);
+    return params.quality == eco ? juce::jmax(2, chosen) : chosen; // Eco is never full rate
+}
+
+bool ReverbProcessor::engineSettingsChanged() const
+{
+    return currentParams.quality != activeQuality || getRateDivisor(currentParams) != activeRateDivisor;
+}
+
+void ReverbProcessor::applyEngineSettings()
+{
+    const int previousQuality = activeQuality;
+    activeQuality = juce::jlimit((int)eco, (int)high, currentParams.quality);
+    activeRateDivisor = getRateDivisor(currentParams);
+
+    // The oversampler sat idle outside High; drop its old filter state
+    if (activeQuality == high && previousQuality != high && saturationOversampler != nullptr)
+        saturationOversampler->reset();
+
+    switch (activeQuality)
+    {
+        case eco:
+            reverb.setTopology(4, activeRateDivisor); // half the combs
+            diffuser.setNumSections(4);
+            delayLine.setInterpolation(MultiTapDelay::Interpolation::linear);
+            break;
+        case high:
+            reverb.setTopology(ReverbNetwork::maxCombs, activeRateDivisor);
+            diffuser.setNumSections(Diffuser::maxSections);
+            delayLine.setInterpolation(MultiTapDelay::Interpolation::cubic);
+            break;
+        default:
+            reverb.setTopology(ReverbNetwork::standardCombs, activeRateDivisor);
+            diffuser.setNumSections(6);
+            delayLine.setInterpolation(MultiTapDelay::Interpolation::linear);
+            break;
+    }
+}
+
+int ReverbProcessor::getActiveStages() const
+{
+    int stages = 0;
+
+    if (currentParams.saturation > 0.0f) stages |= saturationStage;
+    if (currentParams.gateThresh > -100.0f) stages |= gateStage;
+    if (currentParams.dynGain != 0.0f || currentParams.dynDepth != 0.0f) stages |= dynEqStage;
+    if (currentParams.ducking > 0.0f) stages |= duckStage;
+    // Linear phase stays in even when flat, so the latency does not follow the gains
+    if (currentParams.eq3Phase == 1) stages |= eq3LinearStage;
+    else if (currentParams.eq3Low != 0.0f || currentParams.eq3Mid != 0.0f || currentParams.eq3High != 0.0f) stages |= eq3Stage;
+    if (currentParams.msBalance != 50.0f) stages |= msStage;
+    if (currentParams.diffusion > 0.0f) stages |= diffusionStage;
+
+    return stages;
+}
+
+template <int stages>
+void ReverbProcessor::processDynamics(const DynamicsBlock& block) noexcept
+{
+    constexpr bool useGate = (stages & gateStage) != 0;
+    constexpr bool useDynEq = (stages & dynEqStage) != 0;
+    constexpr bool useDuck = (stages & duckStage) != 0;
+
+    const size_t nSamples = block.wet.getNumSamples();
+    StereoFrame frame;
+
+    float gateThreshLin = juce::Decibels::decibelsToGain(currentParams.gateThresh);
+    float dynThreshLin = std::pow(10.0f, currentParams.dynThresh / 20.0f);
+
+    const float gateRel = rateTables->gateRelease;
+    const float dynAtt = rateTables->dynEqAttack;
+    const float dynRel = rateTables->dynEqRelease;
+
+    for (size_t s = 0; s < nSamples; ++s)
+    {
+        const float maxLevel = (useGate || useDynEq) ? block.wetPeak[s] : 0.0f;
+        float totalDynGain = 1.0f;
+
+        if constexpr (useGate)
+        {
+            if (maxLevel > gateThreshLin) gateEnv = 1.0f;
+            else gateEnv += (0.0f - gateEnv) * gateRel;
+        }
+
+        if constexpr (useDynEq)
+        {
+            // DynEQ Detector (wet level, or the sidechain key when selected)
+            float detOut = detectorFilter.processSample(0, block.keyFromSidechain ? block.key[s] : maxLevel);
+            float envIn = std::abs(detOut);
+            if (envIn > dynEqEnv) dynEqEnv += (envIn - dynEqEnv) * dynAtt;
+            else dynEqEnv += (envIn - dynEqEnv) * dynRel;
+
+            float dynGain = 0.0f;
+            if (dynEqEnv > dynThreshLin)
+            {
+                 float excessDb = juce::Decibels::gainToDecibels(dynEqEnv + 0.00001f) - currentParams.dynThresh;
+                 if (excessDb > 0.0f) dynGain = currentParams.dynDepth * std::min(1.0f, excessDb/20.0f);
+            }
+            totalDynGain = juce::Decibels::decibelsToGain(currentParams.dynGain + dynGain);
+        }
+
+        // Apply to L and R together
+        frame.read(block.wet, s);
+        StereoSample samp = frame.load();
+
+        if constexpr (useGate)
+            samp = samp * gateEnv;
+
+        if constexpr (useDynEq)
+        {
+            // Peak approximation: add the band back scaled by the gain change
+            const StereoSample bp = dynEqFilter.processSample(samp);
+            samp = samp + bp * (totalDynGain - 1.0f);
+        }
+
+        if constexpr (useDuck)
+            samp = samp * block.duckGains[s];
+
+        frame.store(samp);
+        frame.write(block.wet, s);
+    }
+
+    // Released to silence, the envelopes and filters would settle on denormals
+    if constexpr (useGate)
+        gateEnv = Denormals::snapToZero(gateEnv);
+
+    if constexpr (useDynEq)
+    {
+        dynEqEnv = Denormals::snapToZero(dynEqEnv);
+        dynEqFilter.snapToZero();
+        detectorFilter.snapToZero();
+    }
 }
 
+// Indexed by the gate/dynEQ/duck bits; nothing runs when all three are neutral
+const ReverbProcessor::DynamicsKernel ReverbProcessor::dynamicsKernels[] = {
+    nullptr,
+    &ReverbProcessor::processDynamics<1>,
+    &ReverbProcessor::processDynamics<2>,
+    &ReverbProcessor::processDynamics<3>,
+    &ReverbProcessor::processDynamics<4>,
+    &ReverbProcessor::processDynamics<5>,
+    &ReverbProcessor::processDynamics<6>,
+    &ReverbProcessor::processDynamics<7>
+};
+
 void ReverbProcessor::setParameters(const ReverbParameters& params)
 {
     currentParams = params;
+
+    // Applied here rather than in process() so the host can be told about
+    // the new latency before the block that uses it.
+    limiter.setLookahead(params.limiterLookahead);
+}
+
+void ReverbProcessor::setMonoInput(bool isMono)
+{
+    monoInput = isMono;
+    reverb.setMonoSource(isMono);
 }
 
-void ReverbProcessor::process(juce::dsp::ProcessContextReplacing<float>& context)
+void ReverbProcessor::process(juce::dsp::ProcessContextReplacing<float>& context, const juce::dsp::AudioBlock<const float>& sidechain)
 {
     // 1. Update DSP Parameters
 
-    juce::dsp::Reverb::Parameters rParams;
+    // Quality tiers at the same network rate (Normal and High) switch in
+    // place and keep the tail: the network adds or fades out combs and the
+    // diffuser crossfades. A change of network rate re-lays out the delay
+    // lines, so it switches behind a short fade and a clear (see
+    // beginTailClear), unless nothing has been processed since the last
+    // prepare or reset and there is no tail to fade.
+    if (engineSettingsChanged())
+    {
+        if (stateIsClear || getRateDivisor(currentParams) == activeRateDivisor)
+            applyEngineSettings();
+        else
+            fadeOutTail(engineSwitchFadeSeconds);
+    }
+    stateIsClear = false;
+
+    ReverbNetwork::Parameters rParams;
     rParams.roomSize = currentParams.feedback / 100.0f;
     rParams.damping = 1.0f - (currentParams.density / 100.0f);
     rParams.width = currentParams.width / 100.0f;
     rParams.wetLevel = 1.0f;
     rParams.dryLevel = 0.0f;
-    rParams.freezeMode = 0.0f;
+    rParams.freezeMode = currentParams.freeze ? 1.0f : 0.0f;
 
     float baseSize = rParams.roomSize;
 
@@ -81,165 +356,247 @@ void ReverbProcessor::process(juce::dsp::ProcessContextReplacing<float>& context
     }
 
     reverb.setParameters(rParams);
+    reverb.setDecayShape({ currentParams.decayLow, currentParams.decayMid, currentParams.decayHigh,
+                           currentParams.decayLowFreq, currentParams.decayHighFreq });
 
     // Pre-Delay
     float delayMs = currentParams.delay;
-    if (currentParams.preDelaySync > 0 && currentParams.bpm > 0)
+    if (currentParams.preDelaySync > 0 && currentParams.bpm > 0
+        && currentParams.preDelaySync < (int)std::size(syncBeats))
     {
         float beatMs = 60000.0f / (float)currentParams.bpm;
-        if (currentParams.preDelaySync == 1) delayMs = beatMs; // 1/4
-        else if (currentParams.preDelaySync == 2) delayMs = beatMs * 0.5f; // 1/8
-        else if (currentParams.preDelaySync == 3) delayMs = beatMs * 0.25f; // 1/16
+        delayMs = beatMs * syncBeats[currentParams.preDelaySync];
     }
-    delayLine.setDelay(delayMs * sampleRate / 1000.0f);
-
-    // Warp
-    chorus.setRate(currentParams.modRate);
-    chorus.setDepth(currentParams.modDepth / 100.0f);
-    chorus.setFeedback((currentParams.warp / 100.0f) * 0.5f);
-    chorus.setMix(0.5f);
+    // Long note values at slow tempos clamp to the buffer (see MultiTapDelay::maxDelaySeconds)
+    // The network's rate conversion delays the tail by a few samples; take
+    // them out of the pre-delay. The linear-phase EQ's much longer delay is
+    // matched on the dry path and reported instead (see getLatencyInSamples).
+    delayLine.setDelay(delayMs * (float)sampleRate / 1000.0f - (float)reverb.getLatencyInSamples());
+
+    delayLine.setNumTaps(currentParams.preDelayTaps);
+    for (int t = 0; t < MultiTapDelay::maxTaps; ++t)
+        delayLine.setTap(t, currentParams.tapGain[t] / 100.0f, currentParams.tapPan[t] / 100.0f);
+
+    // Input diffusion
+    diffuser.setDiffusion(currentParams.diffusion / 100.0f);
+
+    // Warp: sweeps the network's comb taps; nothing runs at zero depth or while frozen
+    const bool modSynced = currentParams.modSync > 0 && currentParams.modSync < (int)std::size(syncBeats);
+    modulation.setRate(currentParams.modRate);
+    modulation.setTempoSync(modSynced ? syncBeats[currentParams.modSync] : 0.0, currentParams.bpm);
+    modulation.setRandomness(currentParams.warp / 100.0f);
+    reverb.setModulation(&modulation, currentParams.freeze ? 0.0f : maxModulationSeconds * currentParams.modDepth / 100.0f);
 
     // Dynamic EQ
-    dynEqFilter.setCutoffFrequency(currentParams.dynFreq);
-    dynEqFilter.setResonance(currentParams.dynQ);
+    dynEqFilter.setParameters(currentParams.dynFreq, currentParams.dynQ);
     detectorFilter.setCutoffFrequency(currentParams.dynFreq);
     detectorFilter.setResonance(currentParams.dynQ);
 
     // 3-Band EQ
-    auto& lowShelf = eq3Chain.get<0>();
-    lowShelf.coefficients = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, 200.0f, 0.71f, juce::Decibels::decibelsToGain(currentParams.eq3Low));
-
-    auto& midPeak = eq3Chain.get<1>();
-    midPeak.coefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 1000.0f, 1.0f, juce::Decibels::decibelsToGain(currentParams.eq3Mid));
+    Eq3Settings eq3Settings;
+    eq3Settings.lowGainDb = currentParams.eq3Low;
+    eq3Settings.midGainDb = currentParams.eq3Mid;
+    eq3Settings.highGainDb = currentParams.eq3High;
+    eq3Settings.lowFreq = currentParams.eq3LowFreq;
+    eq3Settings.midFreq = currentParams.eq3MidFreq;
+    eq3Settings.midQ = currentParams.eq3MidQ;
+    eq3Settings.highFreq = currentParams.eq3HighFreq;
+
+    if (currentParams.eq3Phase == 1)
+    {
+        linearEq.setSettings(eq3Settings); // Redesigned in the background
+    }
+    else if (! eq3Designed || eq3Settings != eq3Applied)
+    {
+        // Redesigned only when a band moves
+        const auto sections = eq3Settings.makeSections(sampleRate);
+        for (int i = 0; i < 3; ++i)
+            eq3.setCoefficients(i, sections[(size_t)i]);
 
-    auto& highShelf = eq3Chain.get<2>();
-    highShelf.coefficients = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, 6000.0f, 0.71f, juce::Decibels::decibelsToGain(currentParams.eq3High));
+        eq3Applied = eq3Settings;
+        eq3Designed = true;
+    }
 
     // Limiter
-    limiter.setThreshold(currentParams.limiterOn ? -0.1f : 10.0f);
+    limiter.setEnabled(currentParams.limiterOn);
+
+    // Neutral stages are skipped; state is reset when a stage comes back in
+    const int stages = getActiveStages();
+    const int entering = stages & ~activeStages;
+
+    if (entering & gateStage) gateEnv = 1.0f; // Opens, then releases if below threshold
+    if (entering & dynEqStage) { dynEqFilter.reset(); detectorFilter.reset(); dynEqEnv = 0.0f; }
+    if (entering & duckStage) duckFollower.reset();
+    if (entering & eq3Stage) eq3.reset();
+    if (entering & eq3LinearStage) linearEq.reset();
+    dryDelay.setDelay((stages & eq3LinearStage) ? linearEq.getLatencyInSamples() : 0);
+    if (entering & diffusionStage) diffuser.reset();
+
+    // The feed stages sat idle while frozen and still hold the audio from
+    // before the freeze; start them from silence instead of replaying it
+    if (wasFrozen && ! currentParams.freeze)
+    {
+        delayLine.flush();
+        diffuser.reset();
+        if (saturationOversampler != nullptr)
+            saturationOversampler->reset();
+    }
+
+    activeStages = stages;
+    wasFrozen = currentParams.freeze;
 
     // 2. Process Audio
     auto& inputBlock = context.getInputBlock();
     auto& outputBlock = context.getOutputBlock();
 
-    wetBuffer.copyFrom(0, 0, inputBlock.getChannelPointer(0), (int)inputBlock.getNumSamples());
-    if (inputBlock.getNumChannels() > 1)
-        wetBuffer.copyFrom(1, 0, inputBlock.getChannelPointer(1), (int)inputBlock.getNumSamples());
-
-    juce::dsp::AudioBlock<float> wetBlock(wetBuffer);
+    const size_t numSamples = inputBlock.getNumSamples();
+    juce::dsp::AudioBlock<float> wetBlock = juce::dsp::AudioBlock<float>(wetBuffer).getSubBlock(0, numSamples);
     juce::dsp::ProcessContextReplacing<float> wetContext(wetBlock);
 
-    // 2.1 Saturation (Pre)
-    float drive = 1.0f + (currentParams.saturation / 20.0f);
-    wetBlock.multiplyBy(drive);
-    saturator.process(wetContext);
-    wetBlock.multiplyBy(1.0f / drive);
-
-    // 2.2 Pre-Delay
-    delayLine.process(wetContext);
+    // Mono into stereo: the dry signal goes to both sides, and everything up
+    // to the network only carries channel 0
+    const bool monoToStereo = monoInput && outputBlock.getNumChannels() > 1 && wetBlock.getNumChannels() > 1;
+    if (monoToStereo)
+        outputBlock.getSingleChannelBlock(1).copyFrom(outputBlock.getSingleChannelBlock(0));
 
-    // 2.3 Warp
-    chorus.process(wetContext);
+    auto feedBlock = monoToStereo ? wetBlock.getSingleChannelBlock(0) : wetBlock;
+    juce::dsp::ProcessContextReplacing<float> feedContext(feedBlock);
 
-    // 2.4 Reverb
-    reverb.process(wetContext);
+    modulation.beginBlock(currentParams.timeInSamples, currentParams.ppqPosition, (int)numSamples);
 
-    // 2.5 Gate, DynEQ, Ducking Loop
-    size_t nSamples = wetBlock.getNumSamples();
-    size_t nChannels = wetBlock.getNumChannels();
+    if (currentParams.freeze)
+    {
+        // Frozen: the reverb loops its tail at unity gain and ignores its input,
+        // so the feed stages (saturation, pre-delay, diffusion) are skipped entirely.
+        wetBlock.clear();
+    }
+    else
+    {
+        feedBlock.copyFrom(inputBlock.getSubsetChannelBlock(0, feedBlock.getNumChannels()));
 
-    float gateThreshLin = juce::Decibels::decibelsToGain(currentParams.gateThresh);
-    float dynThreshLin = std::pow(10.0f, currentParams.dynThresh / 20.0f);
+        // 2.1 Saturation (Pre)
+        if (stages & saturationStage)
+        {
+            float drive = 1.0f + (currentParams.saturation / 20.0f);
+            feedBlock.multiplyBy(drive);
+            if (activeQuality == high)
+            {
+                // 2x oversampled to keep the tanh harmonics from aliasing
+                auto oversampledBlock = saturationOversampler->processSamplesUp(feedBlock);
+                shapeTables->tanh.process(oversampledBlock);
+                saturationOversampler->processSamplesDown(feedBlock);
+            }
+            else
+            {
+                shapeTables->tanh.process(feedBlock);
+            }
+            feedBlock.multiplyBy(1.0f / drive);
+        }
 
-    // Coefficients
-    float gateRel = 1.0f - std::exp(-1.0f / (0.1f * sampleRate));
-    float dynAtt = 1.0f - std::exp(-1.0f / (0.005f * sampleRate));
-    float dynRel = 1.0f - std::exp(-1.0f / (0.1f * sampleRate));
-    float duckAtt = 1.0f - std::exp(-1.0f / (0.01f * sampleRate));
-    float duckRel = 1.0f - std::exp(-1.0f / (0.1f * sampleRate));
+        // 2.2 Pre-Delay, then input diffusion (skipped at 0, as in Harp String)
+        delayLine.process(feedContext);
 
-    float duckIntensity = currentParams.ducking / 100.0f;
+        if (stages & diffusionStage)
+            diffuser.process(feedBlock);
+    }
 
-    for (size_t s = 0; s < nSamples; ++s)
-    {
-        // Gate Level
-        float maxLevel = 0.0f;
-        for (size_t ch=0; ch<nChannels; ++ch) maxLevel = std::max(maxLevel, std::abs(wetBlock.getChannelPointer(ch)[s]));
+    // 2.3 Reverb, with the warp modulation applied inside the network
+    reverb.process(wetContext);
 
-        if (maxLevel > gateThreshLin) gateEnv = 1.0f;
-        else gateEnv += (0.0f - gateEnv) * gateRel;
+    // 2.4 Gate, DynEQ, Ducking Loop
+    size_t nSamples = wetBlock.getNumSamples();
+    size_t nChannels = wetBlock.getNumChannels();
 
-        // DynEQ Detector
-        float detOut = detectorFilter.processSample(0, maxLevel);
-        float envIn = std::abs(detOut);
-        if (envIn > dynEqEnv) dynEqEnv += (envIn - dynEqEnv) * dynAtt;
-        else dynEqEnv += (envIn - dynEqEnv) * dynRel;
+    // Detector key: dry input (linked or mid) or the external sidechain bus
+    const bool useSidechain = currentParams.detectorSource == 2 && sidechain.getNumChannels() > 0
+                           && sidechain.getNumSamples() >= nSamples;
 
-        float dynGain = 0.0f;
-        if (dynEqEnv > dynThreshLin)
-        {
-             float excessDb = juce::Decibels::gainToDecibels(dynEqEnv + 0.00001f) - currentParams.dynThresh;
-             if (excessDb > 0.0f) dynGain = currentParams.dynDepth * std::min(1.0f, excessDb/20.0f);
-        }
-        float totalDynGain = juce::Decibels::decibelsToGain(currentParams.dynGain + dynGain);
+    DynamicsBlock dynamics { wetBlock, detectorBuffer.getWritePointer(0), detectorBuffer.getWritePointer(1),
+                             detectorBuffer.getWritePointer(2), useSidechain };
 
-        // Ducking Envelope (Dry Input)
-        float dryL = std::abs(inputBlock.getChannelPointer(0)[s]);
-        if (dryL > duckEnv) duckEnv += (dryL - duckEnv) * duckAtt;
-        else duckEnv += (dryL - duckEnv) * duckRel;
+    if (stages & (gateStage | dynEqStage))
+    {
+        // Linked wet peak, read by the gate and the wet-keyed dynamic EQ
+        if (nChannels > 1)
+            kernels.linkedPeak(wetBlock.getChannelPointer(0), wetBlock.getChannelPointer(1), dynamics.wetPeak, (int)nSamples);
+        else
+            juce::FloatVectorOperations::abs(dynamics.wetPeak, wetBlock.getChannelPointer(0), (int)nSamples);
+    }
 
-        float duckGain = std::max(0.0f, 1.0f - (duckEnv * duckIntensity * 4.0f));
+    if ((stages & duckStage) || ((stages & dynEqStage) && useSidechain))
+    {
+        const auto keyBlock = useSidechain ? sidechain.getSubBlock(0, nSamples) : inputBlock;
+        const auto keyMode = currentParams.detectorSource == 1 ? EnvelopeFollower::Detector::mid
+                                                               : EnvelopeFollower::Detector::linkedPeak;
+        EnvelopeFollower::computeDetector(keyBlock, keyMode, dynamics.key, nSamples);
+    }
 
-        // Apply Processes per channel
-        for (size_t ch=0; ch<nChannels; ++ch)
-        {
-            float samp = wetBlock.getChannelPointer(ch)[s];
+    if (stages & duckStage)
+    {
+        // Ducking gain curve for the whole block
+        float duckIntensity = currentParams.ducking / 100.0f;
+        juce::FloatVectorOperations::copy(dynamics.duckGains, dynamics.key, (int)nSamples);
+        duckFollower.process(dynamics.duckGains, nSamples);
+        juce::FloatVectorOperations::multiply(dynamics.duckGains, -4.0f * duckIntensity, (int)nSamples);
+        juce::FloatVectorOperations::add(dynamics.duckGains, 1.0f, (int)nSamples);
+        juce::FloatVectorOperations::max(dynamics.duckGains, dynamics.duckGains, 0.0f, (int)nSamples);
+    }
 
-            // Gate
-            samp *= gateEnv;
+    if (auto kernel = dynamicsKernels[stages & (gateStage | dynEqStage | duckStage)])
+        (this->*kernel)(dynamics);
 
-            // DynEQ (Peak Approx)
-            float bp = dynEqFilter.processSample((int)ch, samp);
-            samp = samp + (totalDynGain - 1.0f) * bp;
+    // 2.5 3-Band EQ
+    if (stages & eq3Stage)
+        eq3.process(wetBlock);
+    else if (stages & eq3LinearStage)
+        linearEq.process(wetContext);
 
-            // Ducking
-            samp *= duckGain;
+    // 2.6 M/S Balance
+    if (nChannels == 2 && (stages & msStage))
+    {
+        float balance = currentParams.msBalance / 100.0f;
+        float mGain = (balance < 0.5f) ? 1.0f : 2.0f * (1.0f - balance);
+        float sGain = (balance > 0.5f) ? 1.0f : balance * 2.0f;
 
-            wetBlock.getChannelPointer(ch)[s] = samp;
-        }
+        kernels.midSide(wetBlock.getChannelPointer(0), wetBlock.getChannelPointer(1), (int)nSamples, mGain, sGain);
     }
 
-    // 2.6 3-Band EQ
-    eq3Chain.process(wetContext);
-
-    // 2.7 M/S Balance
-    if (nChannels == 2)
+    // 2.7 Tail Kill: fade, then clear a chunk per block with the wet muted
+    if (tailState != TailState::running)
     {
-        float balance = currentParams.msBalance / 100.0f;
-        for (size_t s=0; s<nSamples; ++s)
-        {
-            float l = wetBlock.getChannelPointer(0)[s];
-            float r = wetBlock.getChannelPointer(1)[s];
-            float m = (l + r) * 0.5f;
-            float side = (l - r) * 0.5f;
+        tailGain.applyGain(wetBuffer, (int)nSamples);
 
-            float mGain = (balance < 0.5f) ? 1.0f : 2.0f * (1.0f - balance);
-            float sGain = (balance > 0.5f) ? 1.0f : balance * 2.0f;
+        if (tailState == TailState::fading && ! tailGain.isSmoothing())
+        {
+            beginTailClear();
+            tailState = TailState::clearing;
+        }
+        else if (tailState == TailState::clearing)
+        {
+            reverb.clearNextChunk(clearChunkSamples);
 
-            wetBlock.getChannelPointer(0)[s] = m * mGain + side * sGain;
-            wetBlock.getChannelPointer(1)[s] = m * mGain - side * sGain;
+            if (! reverb.isClearing())
+            {
+                tailGain.setCurrentAndTargetValue(1.0f);
+                tailState = TailState::running;
+            }
         }
     }
 
-    // 2.9 Mix
+    // 2.8 Mix, with the dry lined up with the wet
+    dryDelay.process(outputBlock);
+
     float wetAmt = currentParams.mix / 100.0f;
     float dryAmt = 1.0f - wetAmt;
 
-    outputBlock.multiplyBy(dryAmt);
-    for (size_t ch=0; ch<nChannels; ++ch)
-        juce::FloatVectorOperations::addWithMultiply(outputBlock.getChannelPointer(ch), wetBlock.getChannelPointer(ch), wetAmt, nSamples);
+    for (size_t ch=0; ch<outputBlock.getNumChannels(); ++ch)
+    {
+        if (ch < nChannels)
+            kernels.mix(outputBlock.getChannelPointer(ch), wetBlock.getChannelPointer(ch), dryAmt, wetAmt, (int)nSamples);
+        else
+            juce::FloatVectorOperations::multiply(outputBlock.getChannelPointer(ch), dryAmt, (int)nSamples);
+    }
 
-    // 2.10 Limiter
-    if (currentParams.limiterOn)
-        limiter.process(context);
+    // 2.9 True-Peak Limiter (always runs its lookahead delay to keep latency constant)
+    limiter.process(context);
 }
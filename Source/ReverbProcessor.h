@@ -1,5 +1,17 @@
 #pragma once
 #include <juce_dsp/juce_dsp.h>
+#include <optional>
+#include "EnvelopeFollower.h"
+#include "TruePeakLimiter.h"
+#include "MultiTapDelay.h"
+#include "ReverbNetwork.h"
+#include "DelayArena.h"
+#include "Diffuser.h"
+#include "DspKernels.h"
+#include "StereoFilters.h"
+#include "LinearPhaseEq.h"
+#include "CompensationDelay.h"
+#include "SharedTables.h"
 
 struct ReverbParameters
 {
@@ -22,16 +34,40 @@ struct ReverbParameters
 
     // New Features
     float ducking = 0.0f;
-    int preDelaySync = 0;
+    int detectorSource = 0; // 0 = Dry L+R, 1 = Mid, 2 = Sidechain
+    int preDelaySync = 0;     // index into the PREDELAY_SYNC note values, 0 = Free
+    int preDelayTaps = 1;
+    float tapGain[MultiTapDelay::maxTaps] = { 100.0f, 100.0f, 100.0f, 100.0f };
+    float tapPan[MultiTapDelay::maxTaps] = { 0.0f, 0.0f, 0.0f, 0.0f };
     float saturation = 0.0f;
     float diffusion = 100.0f;
+    float decayLow = 1.0f;  // RT60 multipliers of the network's low, mid and high bands
+    float decayMid = 1.0f;
+    float decayHigh = 1.0f;
+    float decayLowFreq = 250.0f;   // band edges, Hz
+    float decayHighFreq = 4000.0f;
     float gateThresh = -100.0f;
     float eq3Low = 0.0f;
     float eq3Mid = 0.0f;
     float eq3High = 0.0f;
+    float eq3LowFreq = 200.0f;
+    float eq3MidFreq = 1000.0f;
+    float eq3MidQ = 1.0f;
+    float eq3HighFreq = 6000.0f;
+    int eq3Phase = 0; // 0 = Minimum, 1 = Linear
     float msBalance = 50.0f;
     bool limiterOn = true;
+    float limiterLookahead = 1.0f; // ms
+    bool freeze = false;
+    int quality = 1; // 0 = Eco, 1 = Normal, 2 = High
+    int reverbRate = 0; // network rate: 0 = Full, 1 = 1/2, 2 = 1/4 of the host rate
+    int modSync = 0; // index into the sync note values, 0 = Free (MOD RATE)
     double bpm = 120.0;
+
+    // Host timeline while the transport runs, negative otherwise; keeps the
+    // modulation in phase across instances and renders
+    juce::int64 timeInSamples = -1;
+    double ppqPosition = -1.0;
 };
 
 class ReverbProcessor
@@ -41,41 +77,136 @@ public:
     ~ReverbProcessor();
 
     void prepare(const juce::dsp::ProcessSpec& spec);
-    void process(juce::dsp::ProcessContextReplacing<float>& context);
+    void process(juce::dsp::ProcessContextReplacing<float>& context, const juce::dsp::AudioBlock<const float>& sidechain = {});
     void reset();
 
+    // Ramps the wet output to silence, then drops the tail state without the
+    // full buffer clears of reset(): the pre-delay is invalidated in O(1) and
+    // the network memory is zeroed a chunk per block while the wet stays muted.
+    // A shorter fade takes over one in progress; a longer one is ignored.
+    // Safe to call from the audio thread.
+    void fadeOutTail(float fadeSeconds);
+
     void setParameters(const ReverbParameters& params);
 
-private:
-    juce::dsp::Reverb reverb;
-    juce::dsp::Reverb::Parameters reverbParams;
+    // Mono input into a stereo output: the dry signal is copied to the right
+    // channel, the feed stages run on one channel and the network runs its
+    // single-channel core with a derived stereo output. Mono in and out needs
+    // no flag; a mono spec already runs every stage on one channel.
+    void setMonoInput(bool isMono);
 
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine { 192000 };
-    juce::dsp::Chorus<float> chorus;
+    // Latency introduced by the limiter lookahead and, in linear-phase EQ
+    // mode, the FIR's delay, in samples. Follows setParameters() at once.
+    int getLatencyInSamples() const
+    {
+        return limiter.getLatencyInSamples() + (currentParams.eq3Phase == 1 ? linearEq.getLatencyInSamples() : 0);
+    }
+
+private:
+    void beginTailClear();
+    void applyEngineSettings();
+    bool engineSettingsChanged() const;
+    static int getRateDivisor(const ReverbParameters& params);
+
+    // Wet stages that are not at their neutral setting this block. The
+    // per-sample gate/dynEQ/duck loop is compiled once per combination of its
+    // three bits and picked from dynamicsKernels, so neutral stages cost nothing.
+    enum Stage
+    {
+        gateStage = 1,
+        dynEqStage = 2,
+        duckStage = 4,
+        saturationStage = 8,
+        eq3Stage = 16,
+        msStage = 32,
+        eq3LinearStage = 64, // instead of eq3Stage in linear-phase mode
+        diffusionStage = 128
+    };
+
+    struct DynamicsBlock
+    {
+        juce::dsp::AudioBlock<float> wet;
+        float* key;       // detector key, when ducking or a sidechain-keyed dynEQ needs it
+        float* duckGains;
+        float* wetPeak;   // max |wet| across channels, when the gate or dynEQ runs
+        bool keyFromSidechain;
+    };
+
+    int getActiveStages() const;
+
+    template <int stages>
+    void processDynamics(const DynamicsBlock& block) noexcept;
+
+    using DynamicsKernel = void (ReverbProcessor::*)(const DynamicsBlock&) noexcept;
+    static const DynamicsKernel dynamicsKernels[8];
+
+    ReverbNetwork reverb;
+
+    MultiTapDelay delayLine;
+    Diffuser diffuser;
+
+    // Warp: LFOs sweeping the network's comb taps (no separate chorus pass)
+    ModulationBank modulation;
+    static constexpr float maxModulationSeconds = 0.001f; // at MOD DEPTH 100 the taps sweep 2 ms
 
     // Dynamic EQ
-    juce::dsp::StateVariableTPTFilter<float> dynEqFilter; // Bandpass for mixing
+    StereoSvfBandpass dynEqFilter; // Bandpass for mixing, L/R in one register
     juce::dsp::StateVariableTPTFilter<float> detectorFilter; // Bandpass for detector
 
-    // 3-Band EQ
-    juce::dsp::ProcessorChain<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Filter<float>> eq3Chain;
+    // 3-Band EQ: low shelf, mid peak, high shelf
+    StereoBiquadCascade<3> eq3;
+    Eq3Settings eq3Applied; // the design eq3 currently runs
+    bool eq3Designed = false;
+    LinearPhaseEq linearEq;
+    CompensationDelay dryDelay; // lines the dry up with linearEq's delay
 
     // Dynamics
-    juce::dsp::Limiter<float> limiter;
+    TruePeakLimiter limiter;
     // Simple Gate implementation variables
     float gateEnv = 0.0f;
 
-    // Saturation
-    juce::dsp::WaveShaper<float> saturator;
+    // Saturation (tanh from shapeTables), oversampled in High; built in prepare
+    std::unique_ptr<juce::dsp::Oversampling<float>> saturationOversampler;
 
     double sampleRate = 44100.0;
+    std::optional<juce::dsp::ProcessSpec> preparedSpec; // the last full prepare
+
+    // Read-only tables shared across instances, held from prepare on
+    std::shared_ptr<const RateTables> rateTables;
+    std::shared_ptr<const ShapeTables> shapeTables;
+
+    // Backing store for the pre-delay, diffuser, network and limiter delay lines
+    DelayArena delayArena;
 
     ReverbParameters currentParams;
 
+    int activeStages = 0; // as of the previous block, to reset stages coming back in
+    bool wasFrozen = false; // as of the previous block, to restart the feed stages after a freeze
+    bool monoInput = false;
+
     // Envelopes
-    float duckEnv = 0.0f;
+    EnvelopeFollower duckFollower;
     float dynEqEnv = 0.0f;
 
-    // Pre-allocated buffer for processing
+    // Tail kill (CLEAR, transport stop)
+    enum class TailState { running, fading, clearing };
+    static constexpr size_t clearChunkSamples = 16384;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> tailGain { 1.0f };
+    TailState tailState = TailState::running;
+    float tailFadeSeconds = 0.0f; // full-scale length of the fade in progress
+    bool stateIsClear = true; // nothing processed since prepare() or reset()
+
+    // Quality tier and network rate in effect. A change of network rate fades
+    // the tail out and is applied while the network clears, since it re-lays
+    // out the delay lines; a tier change at the same rate applies at once.
+    enum Quality { eco, normal, high };
+    static constexpr float engineSwitchFadeSeconds = 0.02f;
+    int activeQuality = normal;
+    int activeRateDivisor = 1;
+
+    // Pre-allocated buffers for processing
     juce::AudioBuffer<float> wetBuffer;
+    juce::AudioBuffer<float> detectorBuffer; // 0 = detector key, 1 = ducking gain, 2 = wet peak
+
+    const DspKernels& kernels = DspKernels::get();
 };
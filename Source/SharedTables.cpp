@@ -0,0 +1,94 @@
+#include "SharedTables.h"
+#include <cmath>
+#include <map>
+
+namespace
+{
+    // Weak references only: the cache never keeps a table alive by itself
+    struct Cache
+    {
+        juce::CriticalSection lock;
+        std::weak_ptr<const ShapeTables> shapes;
+        std::map<double, std::weak_ptr<const RateTables>> rates;
+    };
+
+    Cache& getCache()
+    {
+        static Cache cache;
+        return cache;
+    }
+}
+
+SineTable::SineTable()
+{
+    for (int i = 0; i <= size; ++i)
+        values[i] = (float)std::sin(juce::MathConstants<double>::twoPi * i / size);
+}
+
+TanhTable::TanhTable()
+{
+    for (int i = 0; i <= size; ++i)
+        values[i] = (float)std::tanh(-range + 2.0 * range * i / size);
+}
+
+void TanhTable::process(const juce::dsp::AudioBlock<float>& block) const noexcept
+{
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+    {
+        float* samples = block.getChannelPointer(ch);
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+            samples[i] = lookup(samples[i]);
+    }
+}
+
+RateTables::RateTables(double newSampleRate)
+    : sampleRate(newSampleRate),
+      gateRelease(onePole(0.1, newSampleRate)),
+      dynEqAttack(onePole(0.005, newSampleRate)),
+      dynEqRelease(onePole(0.1, newSampleRate)),
+      duckAttack(onePole(0.01, newSampleRate)),
+      duckRelease(onePole(0.1, newSampleRate))
+{
+}
+
+float RateTables::onePole(double seconds, double sampleRate)
+{
+    return (float)(1.0 - std::exp(-1.0 / (seconds * sampleRate)));
+}
+
+std::shared_ptr<const ShapeTables> SharedTables::getShapes()
+{
+    auto& cache = getCache();
+    const juce::ScopedLock sl(cache.lock);
+
+    auto shapes = cache.shapes.lock();
+    if (shapes == nullptr)
+    {
+        shapes = std::make_shared<const ShapeTables>();
+        cache.shapes = shapes;
+    }
+
+    return shapes;
+}
+
+std::shared_ptr<const RateTables> SharedTables::getForSampleRate(double sampleRate)
+{
+    auto& cache = getCache();
+    const juce::ScopedLock sl(cache.lock);
+
+    // Drop rates nobody uses any more
+    for (auto it = cache.rates.begin(); it != cache.rates.end();)
+        it = it->second.expired() ? cache.rates.erase(it) : std::next(it);
+
+    auto& entry = cache.rates[sampleRate];
+    auto tables = entry.lock();
+
+    if (tables == nullptr)
+    {
+        tables = std::make_shared<const RateTables>(sampleRate);
+        entry = tables;
+    }
+
+    return tables;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+
+// Read-only tables and coefficient sets that depend on nothing but the sample
+// rate, shared by every processor in the process. A session with 100
+// instances holds one copy of each instead of 100.
+//
+// Tables are reference counted: the first instance that asks builds them
+// (from prepare, never the audio thread) and they are freed when the last
+// holder lets go. Once built they never change, so the audio thread reads
+// them without locking.
+
+// One sine cycle plus a guard point for interpolation
+struct SineTable
+{
+    static constexpr int size = 2048;
+    float values[size + 1];
+
+    SineTable();
+
+    float lookup(double phase) const noexcept // phase in cycles, 0..1
+    {
+        const double pos = phase * size;
+        const int i = juce::jlimit(0, size - 1, (int)pos);
+        const float frac = (float)(pos - i);
+        return values[i] + frac * (values[i + 1] - values[i]);
+    }
+};
+
+// tanh, interpolated from a table over +-range and clipped to +-1 outside it
+// (within 2e-6 of std::tanh everywhere)
+struct TanhTable
+{
+    static constexpr float range = 8.0f;
+    static constexpr int size = 4096;
+    float values[size + 1];
+
+    TanhTable();
+
+    float lookup(float x) const noexcept
+    {
+        const float pos = (juce::jlimit(-range, range, x) + range) * (size / (2.0f * range));
+        const int i = juce::jmin(size - 1, (int)pos);
+        const float frac = pos - (float)i;
+        return values[i] + frac * (values[i + 1] - values[i]);
+    }
+
+    // In place on every channel of block
+    void process(const juce::dsp::AudioBlock<float>& block) const noexcept;
+};
+
+// Tables independent of the sample rate
+struct ShapeTables
+{
+    SineTable sine;
+    TanhTable tanh;
+};
+
+// Coefficients fixed by the sample rate: one-pole smoothing coefficients,
+// 1 - exp(-1 / (seconds * fs)), of the wet dynamics envelopes
+struct RateTables
+{
+    explicit RateTables(double sampleRate);
+
+    static float onePole(double seconds, double sampleRate);
+
+    double sampleRate;
+    float gateRelease;  // 100 ms
+    float dynEqAttack;  // 5 ms
+    float dynEqRelease; // 100 ms
+    float duckAttack;   // 10 ms
+    float duckRelease;  // 100 ms
+};
+
+class SharedTables
+{
+public:
+    // Not for the audio thread: may build the tables, which allocates.
+    static std::shared_ptr<const ShapeTables> getShapes();
+    static std::shared_ptr<const RateTables> getForSampleRate(double sampleRate);
+
+private:
+    SharedTables() = delete;
+};
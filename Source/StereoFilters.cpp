@@ -0,0 +1,30 @@
+#include "StereoFilters.h"
+#include <cmath>
+
+void StereoSvfBandpass::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    cutoff = -1.0f; // Redesign on the next setParameters
+    reset();
+}
+
+void StereoSvfBandpass::setParameters(float cutoffHz, float resonance)
+{
+    jassert(resonance > 0.0f);
+
+    if (cutoffHz == cutoff && resonance == currentResonance)
+        return; // Called every block; tan() only when something moved
+
+    cutoff = cutoffHz;
+    currentResonance = resonance;
+
+    g = (float)std::tan(juce::MathConstants<double>::pi * cutoffHz / sampleRate);
+    const float r2 = 1.0f / resonance;
+    gPlusR2 = g + r2;
+    h = 1.0f / (1.0f + r2 * g + g * g);
+}
+
+void StereoSvfBandpass::reset() noexcept
+{
+    s1 = s2 = StereoSample {};
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "Denormals.h"
+
+// Recursive filters that run a stereo pair as one SIMD register: L and R sit
+// in lanes 0 and 1 (any further lanes are unused), so the state update of
+// each filter happens once per sample instead of once per channel. Feedback
+// filters cannot vectorise over time, but they can over channels.
+using StereoSample = juce::dsp::SIMDRegister<float>;
+
+// Moves one L/R pair between channel buffers and a StereoSample. Mono
+// blocks use lane 0 only.
+struct StereoFrame
+{
+    alignas(sizeof(StereoSample)) float lanes[StereoSample::size()] = {};
+
+    void read(const juce::dsp::AudioBlock<float>& block, size_t index) noexcept
+    {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            lanes[ch] = block.getChannelPointer(ch)[index];
+    }
+
+    void write(const juce::dsp::AudioBlock<float>& block, size_t index) const noexcept
+    {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            block.getChannelPointer(ch)[index] = lanes[ch];
+    }
+
+    StereoSample load() const noexcept { return StereoSample::fromRawArray(lanes); }
+    void store(StereoSample value) noexcept { value.copyToRawArray(lanes); }
+
+    // Denormals::snapToZero on every lane
+    static StereoSample snapToZero(StereoSample value) noexcept
+    {
+        StereoFrame frame;
+        frame.store(value);
+        for (auto& lane : frame.lanes)
+            lane = Denormals::snapToZero(lane);
+        return frame.load();
+    }
+};
+
+// TPT state-variable bandpass, the same topology and coefficients as
+// juce::dsp::StateVariableTPTFilter in bandpass mode.
+class StereoSvfBandpass
+{
+public:
+    void prepare(double newSampleRate);
+    void setParameters(float cutoffHz, float resonance);
+    void reset() noexcept;
+
+    // Once per block, after processing; see Denormals.h
+    void snapToZero() noexcept
+    {
+        s1 = StereoFrame::snapToZero(s1);
+        s2 = StereoFrame::snapToZero(s2);
+    }
+
+    StereoSample processSample(StereoSample input) noexcept
+    {
+        const StereoSample highpass = (input - s1 * gPlusR2 - s2) * h;
+        const StereoSample bandpass = highpass * g + s1;
+        s1 = highpass * g + bandpass;
+
+        const StereoSample lowpass = bandpass * g + s2;
+        s2 = bandpass * g + lowpass;
+
+        return bandpass;
+    }
+
+private:
+    double sampleRate = 44100.0;
+    float cutoff = -1.0f, currentResonance = 0.0f;
+    float g = 0.0f, gPlusR2 = 0.0f, h = 1.0f;
+    StereoSample s1 {}, s2 {};
+};
+
+// Serial second-order sections in transposed direct form II, the form
+// juce::dsp::IIR::Filter uses. Each stereo sample passes through every
+// section before the next one is read, so the cascade costs one pass over
+// the block rather than one per section and channel.
+template <int numSections>
+class StereoBiquadCascade
+{
+public:
+    // Raw { b0, b1, b2, a0, a1, a2 } as returned by IIR::ArrayCoefficients;
+    // normalised here, without allocating.
+    void setCoefficients(int section, const std::array<float, 6>& c) noexcept
+    {
+        auto& sec = sections[(size_t)section];
+        const float a0Inv = 1.0f / c[3];
+        sec.b0 = c[0] * a0Inv;
+        sec.b1 = c[1] * a0Inv;
+        sec.b2 = c[2] * a0Inv;
+        sec.a1 = c[4] * a0Inv;
+        sec.a2 = c[5] * a0Inv;
+    }
+
+    void reset() noexcept
+    {
+        for (auto& sec : sections)
+            sec.z1 = sec.z2 = StereoSample {};
+    }
+
+    // Once per block, after processing; see Denormals.h
+    void snapToZero() noexcept
+    {
+        for (auto& sec : sections)
+        {
+            sec.z1 = StereoFrame::snapToZero(sec.z1);
+            sec.z2 = StereoFrame::snapToZero(sec.z2);
+        }
+    }
+
+    StereoSample processSample(StereoSample x) noexcept
+    {
+        for (auto& sec : sections)
+        {
+            const StereoSample y = x * sec.b0 + sec.z1;
+            sec.z1 = x * sec.b1 - y * sec.a1 + sec.z2;
+            sec.z2 = x * sec.b2 - y * sec.a2;
+            x = y;
+        }
+
+        return x;
+    }
+
+    // In place on a mono or stereo block
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        jassert(block.getNumChannels() <= 2);
+        StereoFrame frame;
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+        {
+            frame.read(block, i);
+            frame.store(processSample(frame.load()));
+            frame.write(block, i);
+        }
+
+        snapToZero();
+    }
+
+private:
+    struct Section
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        StereoSample z1 {}, z2 {};
+    };
+
+    std::array<Section, (size_t)numSections> sections;
+};
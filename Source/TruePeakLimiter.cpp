@@ -0,0 +1,211 @@
+#include "TruePeakLimiter.h"
+#include "DelayArena.h"
+#include <cmath>
+
+TruePeakLimiter::TruePeakLimiter()
+{
+    setThreshold(-0.1f);
+}
+
+void TruePeakLimiter::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    sampleRate = spec.sampleRate;
+    numChannels = juce::jmin(maxChannels, (int)spec.numChannels);
+
+    // 4x (two halfband stages) is enough to catch inter-sample overs within ~0.5 dB.
+    oversampling = std::make_unique<juce::dsp::Oversampling<float>>(spec.numChannels, 2,
+        juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, false, true);
+    oversampling->initProcessing(spec.maximumBlockSize);
+    detectorLatency = (int)oversampling->getLatencyInSamples();
+
+    maxLookaheadSamples = (int)std::ceil(maxLookaheadMs * 0.001 * sampleRate);
+
+    const int maxDelay = maxLookaheadSamples + detectorLatency;
+    delaySize = maxDelay + (int)spec.maximumBlockSize + 1;
+
+    peakBuffer.assign(spec.maximumBlockSize, 0.0f);
+    gainBuffer.assign(spec.maximumBlockSize, 1.0f);
+
+    dequeValues.assign((size_t)maxLookaheadSamples + 2, 0.0f);
+    dequeIndices.assign((size_t)maxLookaheadSamples + 2, 0);
+    boxBuffer.assign((size_t)maxLookaheadSamples + 1, 1.0f);
+
+    setRelease(releaseMs);
+    updateLookahead();
+}
+
+size_t TruePeakLimiter::getRequiredStorage() const
+{
+    return (size_t)numChannels * DelayArena::alignedSize((size_t)delaySize);
+}
+
+void TruePeakLimiter::setStorage(float* storage)
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+        delayData[ch] = ch < numChannels ? storage + (size_t)ch * DelayArena::alignedSize((size_t)delaySize) : nullptr;
+
+    reset();
+}
+
+void TruePeakLimiter::reset()
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        if (delayData[ch] != nullptr)
+            juce::FloatVectorOperations::clear(delayData[ch], delaySize);
+
+    writePos = 0;
+
+    if (oversampling != nullptr)
+        oversampling->reset();
+
+    resetGainComputer();
+}
+
+void TruePeakLimiter::setThreshold(float thresholdDb)
+{
+    threshold = juce::Decibels::decibelsToGain(thresholdDb);
+}
+
+void TruePeakLimiter::setRelease(float newReleaseMs)
+{
+    releaseMs = newReleaseMs;
+    releaseCoeff = 1.0f - std::exp(-1.0f / (releaseMs * 0.001f * (float)sampleRate));
+}
+
+void TruePeakLimiter::setLookahead(float newLookaheadMs)
+{
+    lookaheadMs = juce::jlimit(0.0f, maxLookaheadMs, newLookaheadMs);
+    updateLookahead();
+}
+
+void TruePeakLimiter::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled && ! enabled)
+        resetGainComputer();
+
+    enabled = shouldBeEnabled;
+}
+
+void TruePeakLimiter::updateLookahead()
+{
+    const int newLookahead = juce::jlimit(0, maxLookaheadSamples, juce::roundToInt(lookaheadMs * 0.001 * sampleRate));
+
+    if (newLookahead == lookaheadSamples && delaySamples == lookaheadSamples + detectorLatency)
+        return;
+
+    lookaheadSamples = newLookahead;
+    windowSize = lookaheadSamples + 1;
+    delaySamples = lookaheadSamples + detectorLatency;
+
+    if (! boxBuffer.empty())
+        resetGainComputer();
+}
+
+void TruePeakLimiter::resetGainComputer()
+{
+    dequeHead = 0;
+    dequeSize = 0;
+    releaseGain = 1.0f;
+
+    std::fill(boxBuffer.begin(), boxBuffer.end(), 1.0f);
+    boxPos = 0;
+    boxSum = (double)windowSize;
+}
+
+void TruePeakLimiter::computeGains(const juce::dsp::AudioBlock<const float>& input, int numSamples)
+{
+    // 1. Inter-sample peaks: rectify the 4x signal and reduce each group of
+    //    oversampled frames (all channels linked) to one peak per base sample.
+    auto upBlock = oversampling->processSamplesUp(input);
+    const int factor = (int)oversampling->getOversamplingFactor();
+    const int channels = (int)upBlock.getNumChannels();
+
+    for (int ch = 0; ch < channels; ++ch)
+        juce::FloatVectorOperations::abs(upBlock.getChannelPointer((size_t)ch), upBlock.getChannelPointer((size_t)ch), numSamples * factor);
+
+    float* peaks = peakBuffer.data();
+    juce::FloatVectorOperations::clear(peaks, numSamples);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float* os = upBlock.getChannelPointer((size_t)ch);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float p = peaks[i];
+            for (int k = 0; k < factor; ++k)
+                p = std::max(p, os[i * factor + k]);
+            peaks[i] = p;
+        }
+    }
+
+    // 2. Gain computer
+    const int capacity = (int)dequeValues.size();
+    float* gains = gainBuffer.data();
+
+    for (int i = 0; i < numSamples; ++i, ++sampleCounter)
+    {
+        const float peak = peaks[i];
+
+        // Sliding-window maximum: drop candidates that can no longer be the max...
+        while (dequeSize > 0 && dequeValues[(size_t)((dequeHead + dequeSize - 1) % capacity)] <= peak)
+            --dequeSize;
+
+        const int tail = (dequeHead + dequeSize) % capacity;
+        dequeValues[(size_t)tail] = peak;
+        dequeIndices[(size_t)tail] = sampleCounter;
+        ++dequeSize;
+
+        // ...and those that have left the window.
+        while (dequeIndices[(size_t)dequeHead] <= sampleCounter - windowSize)
+        {
+            dequeHead = (dequeHead + 1) % capacity;
+            --dequeSize;
+        }
+
+        const float windowPeak = dequeValues[(size_t)dequeHead];
+        const float target = windowPeak > threshold ? threshold / windowPeak : 1.0f;
+
+        if (target < releaseGain) releaseGain = target;
+        else releaseGain += (target - releaseGain) * releaseCoeff;
+
+        boxSum += (double)(releaseGain - boxBuffer[(size_t)boxPos]);
+        boxBuffer[(size_t)boxPos] = releaseGain;
+        if (++boxPos >= windowSize) boxPos = 0;
+
+        gains[i] = (float)(boxSum / (double)windowSize);
+    }
+}
+
+void TruePeakLimiter::process(const juce::dsp::ProcessContextReplacing<float>& context)
+{
+    auto& block = context.getOutputBlock();
+    const int numSamples = (int)block.getNumSamples();
+    const int channels = juce::jmin(numChannels, (int)block.getNumChannels());
+
+    // Detection must see the input before the delay below overwrites it in place.
+    if (enabled)
+        computeGains(context.getInputBlock(), numSamples);
+
+    const int bufferSize = delaySize;
+    const int readPos = (writePos - delaySamples + bufferSize) % bufferSize;
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* io = block.getChannelPointer((size_t)ch);
+        float* ring = delayData[ch];
+
+        const int writeFirst = juce::jmin(numSamples, bufferSize - writePos);
+        juce::FloatVectorOperations::copy(ring + writePos, io, writeFirst);
+        juce::FloatVectorOperations::copy(ring, io + writeFirst, numSamples - writeFirst);
+
+        const int readFirst = juce::jmin(numSamples, bufferSize - readPos);
+        juce::FloatVectorOperations::copy(io, ring + readPos, readFirst);
+        juce::FloatVectorOperations::copy(io + readFirst, ring, numSamples - readFirst);
+
+        if (enabled)
+            juce::FloatVectorOperations::multiply(io, gainBuffer.data(), numSamples);
+    }
+
+    writePos = (writePos + numSamples) % bufferSize;
+}
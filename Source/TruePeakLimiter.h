@@ -0,0 +1,83 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+// Lookahead brickwall limiter with 4x oversampled inter-sample peak detection.
+//
+// Gain computer: a sliding-window maximum (monotonic deque) over the lookahead
+// window, a release one-pole, then a box filter of the same length. The box
+// filter ramps the gain down across the lookahead so it has fully settled by
+// the time the peak leaves the delay line.
+//
+// The lookahead delay lives in the owner's DelayArena: prepare() sizes it,
+// setStorage() hands it over.
+class TruePeakLimiter
+{
+public:
+    static constexpr float maxLookaheadMs = 5.0f;
+
+    TruePeakLimiter();
+
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    size_t getRequiredStorage() const;
+    void setStorage(float* storage);
+    void reset();
+
+    void setThreshold(float thresholdDb);
+    void setRelease(float releaseMs);
+    void setLookahead(float lookaheadMs);
+
+    // When disabled the signal still runs through the lookahead delay so the
+    // reported latency does not change with the limiter switch.
+    void setEnabled(bool shouldBeEnabled);
+
+    // Lookahead plus the oversampled detector's group delay.
+    int getLatencyInSamples() const { return delaySamples; }
+
+    void process(const juce::dsp::ProcessContextReplacing<float>& context);
+
+private:
+    void updateLookahead();
+    void resetGainComputer();
+    void computeGains(const juce::dsp::AudioBlock<const float>& input, int numSamples);
+
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+
+    float threshold = 1.0f;
+    float releaseMs = 100.0f;
+    float releaseCoeff = 1.0f;
+    float lookaheadMs = 1.0f;
+    bool enabled = true;
+
+    int detectorLatency = 0;
+    int maxLookaheadSamples = 0;
+    int lookaheadSamples = 0;
+    int windowSize = 1;
+    int delaySamples = 0;
+
+    // Lookahead delay
+    static constexpr int maxChannels = 2;
+    float* delayData[maxChannels] = { nullptr, nullptr };
+    int delaySize = 0;
+    int writePos = 0;
+
+    // Per-block detector and gain curves
+    std::vector<float> peakBuffer;
+    std::vector<float> gainBuffer;
+
+    // Monotonic deque (ring) of window peak candidates
+    std::vector<float> dequeValues;
+    std::vector<juce::int64> dequeIndices;
+    int dequeHead = 0;
+    int dequeSize = 0;
+    juce::int64 sampleCounter = 0;
+
+    // Release and box smoothing
+    float releaseGain = 1.0f;
+    std::vector<float> boxBuffer;
+    int boxPos = 0;
+    double boxSum = 1.0;
+};
@@ -0,0 +1,118 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include <iostream>
+// cmake --build build --config Debug --target EngineSwitchTest
+//
+// Checks engine settings changed while audio runs, fully wet (MIX 100):
+//
+// - QUALITY Normal -> High -> Normal during a tail keeps the tail: the level
+//   carries on and no sample steps further than the tail itself does.
+// - REVERB_RATE 1/2 on running noise re-lays out the network behind a fade;
+//   after the fade and the clear, the wet must come back.
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr float level = 0.25f;
+
+    int check(bool condition, const juce::String& message)
+    {
+        if (! condition)
+            std::cerr << message << std::endl;
+        return condition ? 0 : 1;
+    }
+
+    struct Segment
+    {
+        float rms = 0.0f;
+        float maxStep = 0.0f; // largest difference between consecutive samples
+    };
+
+    struct Render
+    {
+        FDNRAudioProcessor& plugin;
+        juce::AudioBuffer<float> buffer { 2, blockSize };
+        juce::MidiBuffer midi;
+        juce::Random random { 1234 };
+        float last[2] = {};
+
+        // Renders 'seconds' of noise (or silence) and measures the last 'measureSeconds'
+        Segment run(double seconds, double measureSeconds, bool noise)
+        {
+            const int numBlocks = juce::jmax(1, (int)(seconds * sampleRate) / blockSize);
+            const int measureBlocks = juce::jlimit(1, numBlocks, (int)(measureSeconds * sampleRate) / blockSize);
+            double sum = 0.0;
+            Segment segment;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample(ch, i, noise ? level * (random.nextFloat() * 2.0f - 1.0f) : 0.0f);
+
+                plugin.processBlock(buffer, midi);
+                const bool measured = b >= numBlocks - measureBlocks;
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const float sample = buffer.getSample(ch, i);
+                        if (measured)
+                        {
+                            sum += sample * sample;
+                            segment.maxStep = juce::jmax(segment.maxStep, std::abs(sample - last[ch]));
+                        }
+                        last[ch] = sample;
+                    }
+            }
+
+            segment.rms = (float)std::sqrt(sum / (measureBlocks * blockSize * buffer.getNumChannels()));
+            return segment;
+        }
+    };
+
+    // Switches QUALITY to 'quality' during a tail and checks the tail carries on
+    int switchQualityInTail(FDNRAudioProcessor& plugin, Render& render, float quality, const juce::String& name)
+    {
+        render.run(1.0, 0.1, true);
+        const auto before = render.run(0.1, 0.05, false);
+
+        plugin.getAPVTS().getParameterAsValue("QUALITY").setValue(quality);
+        const auto after = render.run(0.05, 0.05, false);
+
+        int failures = check(before.rms > 1.0e-3f, name + ": no tail before the switch");
+        failures += check(after.rms > 0.3f * before.rms, name + ": tail dropped from RMS " + juce::String(before.rms)
+                                                             + " to " + juce::String(after.rms));
+        failures += check(after.maxStep < 2.0f * before.maxStep + 1.0e-4f, name + ": step of " + juce::String(after.maxStep)
+                                                                              + " after the switch, tail steps up to " + juce::String(before.maxStep));
+        return failures;
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    FDNRAudioProcessor plugin;
+    plugin.resetAllParametersToDefault();
+    plugin.getAPVTS().getParameterAsValue("MIX").setValue(100.0f);
+    plugin.prepareToPlay(sampleRate, blockSize);
+
+    Render render { plugin };
+    int failures = 0;
+
+    failures += switchQualityInTail(plugin, render, 2.0f, "Normal -> High");
+    failures += switchQualityInTail(plugin, render, 1.0f, "High -> Normal");
+
+    const float before = render.run(1.0, 0.25, true).rms;
+    failures += check(before > 0.01f, "No wet signal before the rate switch: RMS " + juce::String(before));
+
+    plugin.getAPVTS().getParameterAsValue("REVERB_RATE").setValue(1.0f); // 1/2
+    const float after = render.run(1.0, 0.25, true).rms;
+    failures += check(after > 0.25f * before, "Wet signal did not come back after the REVERB_RATE switch: RMS "
+                                                  + juce::String(after) + ", before " + juce::String(before));
+
+    std::cout << (failures == 0 ? "Passed" : "Failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
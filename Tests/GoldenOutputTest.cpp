@@ -0,0 +1,231 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../Source/PluginProcessor.h"
+#include <iostream>
+// cmake --build build --config Debug --target GoldenOutputTest
+//
+// Renders fixed test signals through every mode of setParametersForMode and
+// compares the result with the references in Tests/Golden. References are
+// stored as per-window RMS and peak (both channels), which catches level,
+// decay and tonal changes without checking megabytes of audio into the repo.
+//
+// A missing reference is a failure, so a checkout without references never
+// passes by default. Record them (first time, or after an intentional change
+// in sound) with:  GoldenOutputTest --record
+// using the CI toolchain, and note the change in Tests/Golden/README.md.
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 256;
+    constexpr int renderLength = 48000;     // 1 s
+    constexpr int windowSize = 256;         // reference resolution
+    constexpr float absTolerance = 1.0e-4f; // ~ -80 dBFS
+    constexpr float relTolerance = 0.01f;   // ~ 0.09 dB
+
+    struct TestSignal
+    {
+        const char* name;
+        void (*fill)(juce::AudioBuffer<float>&);
+    };
+
+    void fillImpulse(juce::AudioBuffer<float>& buffer)
+    {
+        buffer.clear();
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            buffer.setSample(ch, 0, 1.0f);
+    }
+
+    void fillSweep(juce::AudioBuffer<float>& buffer)
+    {
+        // Exponential sweep 20 Hz - 20 kHz over 0.5 s, then silence
+        buffer.clear();
+        const double f0 = 20.0, f1 = 20000.0, length = 0.5;
+        const double k = std::log(f1 / f0);
+        const int numSweep = (int)(length * sampleRate);
+
+        for (int i = 0; i < numSweep; ++i)
+        {
+            const double t = i / sampleRate;
+            const double phase = juce::MathConstants<double>::twoPi * f0 * length / k * (std::exp(t / length * k) - 1.0);
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, 0.5f * (float)std::sin(phase));
+        }
+    }
+
+    void fillNoiseBurst(juce::AudioBuffer<float>& buffer)
+    {
+        // 50 ms of seeded, independent white noise per channel, then silence
+        buffer.clear();
+        juce::Random random(1234);
+        const int numBurst = (int)(0.05 * sampleRate);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < numBurst; ++i)
+                buffer.setSample(ch, i, 0.5f * (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    const TestSignal signals[] = {
+        { "impulse", fillImpulse },
+        { "sweep", fillSweep },
+        { "noise", fillNoiseBurst }
+    };
+
+    // Renders one signal through a fresh plugin instance set to the given mode.
+    // Returns the wall time spent in processBlock, in milliseconds.
+    double render(int mode, const TestSignal& signal, juce::AudioBuffer<float>& io)
+    {
+        FDNRAudioProcessor plugin;
+        plugin.resetAllParametersToDefault();
+        plugin.getAPVTS().getParameterAsValue("MODE").setValue((float)mode);
+        plugin.setParametersForMode(mode);
+        plugin.prepareToPlay(sampleRate, blockSize);
+
+        signal.fill(io);
+
+        juce::MidiBuffer midi;
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int pos = 0; pos < renderLength; pos += blockSize)
+        {
+            juce::AudioBuffer<float> block(io.getArrayOfWritePointers(), io.getNumChannels(), pos, juce::jmin(blockSize, renderLength - pos));
+            plugin.processBlock(block, midi);
+        }
+
+        return juce::Time::getMillisecondCounterHiRes() - start;
+    }
+
+    // Per window: RMS L, RMS R, peak L, peak R
+    std::vector<float> summarise(const juce::AudioBuffer<float>& rendered)
+    {
+        std::vector<float> summary;
+
+        for (int pos = 0; pos < rendered.getNumSamples(); pos += windowSize)
+        {
+            const int n = juce::jmin(windowSize, rendered.getNumSamples() - pos);
+            for (int ch = 0; ch < 2; ++ch)
+                summary.push_back(rendered.getRMSLevel(ch, pos, n));
+            for (int ch = 0; ch < 2; ++ch)
+                summary.push_back(rendered.getMagnitude(ch, pos, n));
+        }
+
+        return summary;
+    }
+
+    void writeReference(const juce::File& file, const std::vector<float>& summary)
+    {
+        juce::String text;
+        for (size_t i = 0; i < summary.size(); i += 4)
+            text << juce::String(summary[i], 9) << " " << juce::String(summary[i + 1], 9) << " "
+                 << juce::String(summary[i + 2], 9) << " " << juce::String(summary[i + 3], 9) << "\n";
+
+        file.getParentDirectory().createDirectory();
+        file.replaceWithText(text);
+    }
+
+    std::vector<float> readReference(const juce::File& file)
+    {
+        std::vector<float> summary;
+        auto tokens = juce::StringArray::fromTokens(file.loadFileAsString(), " \n", "");
+        tokens.removeEmptyStrings();
+
+        for (auto& token : tokens)
+            summary.push_back(token.getFloatValue());
+
+        return summary;
+    }
+
+    // Returns the number of values outside tolerance, printing the first one.
+    int compare(const std::vector<float>& actual, const std::vector<float>& expected, const juce::String& testName)
+    {
+        if (actual.size() != expected.size())
+        {
+            std::cerr << testName << ": reference has " << expected.size() << " values, render has " << actual.size() << std::endl;
+            return (int)std::max(actual.size(), expected.size());
+        }
+
+        int failures = 0;
+        for (size_t i = 0; i < actual.size(); ++i)
+        {
+            if (std::abs(actual[i] - expected[i]) > absTolerance + relTolerance * std::abs(expected[i]))
+            {
+                if (failures == 0)
+                    std::cerr << testName << ": window " << (i / 4) << " value " << (i % 4)
+                              << " is " << actual[i] << ", expected " << expected[i] << std::endl;
+                ++failures;
+            }
+        }
+
+        return failures;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    bool record = false;
+    for (int i = 1; i < argc; ++i)
+        if (juce::String(argv[i]) == "--record")
+            record = true;
+
+    juce::File cwd = juce::File::getCurrentWorkingDirectory();
+    juce::File goldenDir = cwd.getChildFile("Tests").getChildFile("Golden");
+    juce::File testDir = cwd.getChildFile("TestOutput");
+    testDir.createDirectory();
+
+    juce::StringArray modeNames;
+    {
+        FDNRAudioProcessor plugin;
+        modeNames = plugin.getAPVTS().getParameter("MODE")->getAllValueStrings();
+    }
+
+    juce::AudioBuffer<float> io(2, renderLength);
+    juce::String timing("mode,signal,render_ms,realtime_factor\n");
+    int failedTests = 0, recordedTests = 0;
+
+    for (int mode = 0; mode < modeNames.size(); ++mode)
+    {
+        for (auto& signal : signals)
+        {
+            const juce::String testName = modeNames[mode].removeCharacters(" ") + "_" + signal.name;
+            const double ms = render(mode, signal, io);
+            const double realtimeFactor = (renderLength / sampleRate * 1000.0) / juce::jmax(ms, 1.0e-6);
+
+            timing << testName.upToFirstOccurrenceOf("_", false, false) << "," << signal.name << ","
+                   << juce::String(ms, 3) << "," << juce::String(realtimeFactor, 1) << "\n";
+
+            auto summary = summarise(io);
+            juce::File reference = goldenDir.getChildFile(testName + ".golden");
+
+            if (record)
+            {
+                writeReference(reference, summary);
+                ++recordedTests;
+                std::cout << "Recorded " << reference.getFullPathName() << std::endl;
+                continue;
+            }
+
+            if (! reference.existsAsFile())
+            {
+                std::cerr << testName << ": no reference at " << reference.getFullPathName()
+                          << " (record with --record)" << std::endl;
+                ++failedTests;
+                continue;
+            }
+
+            if (compare(summary, readReference(reference), testName) > 0)
+                ++failedTests;
+        }
+    }
+
+    juce::File timingFile = testDir.getChildFile("golden_timing.csv");
+    timingFile.replaceWithText(timing);
+    std::cout << timing << "Timing written to " << timingFile.getFullPathName() << std::endl;
+
+    const int total = modeNames.size() * (int)std::size(signals);
+    std::cout << (total - failedTests - recordedTests) << " passed, " << failedTests << " failed, "
+              << recordedTests << " recorded" << std::endl;
+
+    return failedTests == 0 ? 0 : 1;
+}
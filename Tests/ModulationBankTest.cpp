@@ -0,0 +1,114 @@
+#include <juce_core/juce_core.h>
+#include "../Source/ModulationBank.h"
+#include <iostream>
+// cmake --build build --config Debug --target ModulationBankTest
+//
+// Checks that the LFO voices stay continuous when the rate changes mid-block.
+// The bank runs in sub-blocks (as processBlock splits at parameter events)
+// far into the timeline, where the absolute phase of a new rate is unrelated
+// to the old one, and changes MOD RATE, the sync note value and the tempo at
+// a sub-block boundary. No voice may step by more than its own slope allows.
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr double startSeconds = 100.3;
+
+    // Largest step per sample of a voice at 'cyclesPerSecond': the sine and
+    // the smoothstepped random walk each move at most ~2 pi and 3 per cycle
+    float maxStep(double cyclesPerSecond)
+    {
+        return (float)((juce::MathConstants<double>::twoPi + 3.0) * cyclesPerSecond / sampleRate) * 1.5f + 1.0e-5f;
+    }
+
+    struct Run
+    {
+        ModulationBank bank;
+        juce::int64 position;  // host samples; negative runs the bank's own clock
+        float previous[ModulationBank::maxVoices] = {};
+        bool started = false;
+        float worstStep = 0.0f;
+        double worstAllowedRate = 0.0;
+
+        explicit Run(bool hostPosition) : position(hostPosition ? (juce::int64)(startSeconds * sampleRate) : -1)
+        {
+            bank.prepare(sampleRate);
+            bank.setRandomness(0.5f);
+        }
+
+        // Runs numSamples as one sub-block, tracking the largest step between
+        // consecutive samples relative to what 'cyclesPerSecond' allows
+        void subBlock(int numSamples, double cyclesPerSecond)
+        {
+            bank.beginBlock(position, -1.0, numSamples);
+            if (position >= 0)
+                position += numSamples;
+
+            for (int i = 0; i < numSamples; ++i)
+                for (int voice = 0; voice < ModulationBank::maxVoices; ++voice)
+                {
+                    const float value = bank.getValue(voice, i / sampleRate);
+                    if (started)
+                    {
+                        const float ratio = std::abs(value - previous[voice]) / maxStep(cyclesPerSecond);
+                        if (ratio > worstStep)
+                        {
+                            worstStep = ratio;
+                            worstAllowedRate = cyclesPerSecond;
+                        }
+                    }
+                    previous[voice] = value;
+                }
+
+            started = true;
+        }
+    };
+
+    int check(const Run& run, const juce::String& name)
+    {
+        if (run.worstStep <= 1.0f)
+            return 0;
+
+        std::cerr << name << ": a voice stepped " << run.worstStep << "x the largest step at "
+                  << run.worstAllowedRate << " cycles/s" << std::endl;
+        return 1;
+    }
+}
+
+int main()
+{
+    int failures = 0;
+
+    // MOD RATE 0.5 -> 3 Hz, 200 samples into the second block, host running
+    {
+        Run run(true);
+        run.bank.setRate(0.5f);
+        run.subBlock(blockSize, 0.5);
+        run.subBlock(200, 0.5);
+        run.bank.setRate(3.0f);
+        run.subBlock(blockSize - 200, 3.0);
+        run.subBlock(blockSize, 3.0);
+        failures += check(run, "MOD RATE change");
+    }
+
+    // Sync 1/4 -> 1/8 note at 120 BPM, then 120 -> 97 BPM, transport stopped
+    {
+        Run run(false);
+        run.bank.setTempoSync(1.0, 120.0);
+        for (int i = 0; i < 200; ++i) // ~2 s into the free-running clock
+            run.subBlock(blockSize, 2.0);
+
+        run.subBlock(300, 2.0);
+        run.bank.setTempoSync(0.5, 120.0);
+        run.subBlock(blockSize - 300, 4.0);
+        run.subBlock(100, 4.0);
+        run.bank.setTempoSync(0.5, 97.0);
+        run.subBlock(blockSize - 100, 4.0);
+        run.subBlock(blockSize, 4.0);
+        failures += check(run, "MOD SYNC / tempo change");
+    }
+
+    std::cout << (failures == 0 ? "Passed" : "Failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
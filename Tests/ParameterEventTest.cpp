@@ -0,0 +1,83 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include <iostream>
+// cmake --build build --config Debug --target ParameterEventTest
+//
+// Checks that FDNRAudioProcessor::postParameterChange lands where it is
+// posted. A DC input runs fully dry (MIX 0), then MIX is posted to 100 part
+// way into a block. The wet stays silent for the pre-delay, so the output
+// must step from the input level to zero exactly at the event's grid offset
+// plus the reported latency.
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr float level = 0.25f;
+    constexpr float tolerance = 1.0e-4f;
+
+    int check(bool condition, const juce::String& message)
+    {
+        if (! condition)
+            std::cerr << message << std::endl;
+        return condition ? 0 : 1;
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    FDNRAudioProcessor plugin;
+    plugin.resetAllParametersToDefault();
+    plugin.getAPVTS().getParameterAsValue("MIX").setValue(0.0f);
+    plugin.getAPVTS().getParameterAsValue("DELAY").setValue(500.0f);
+    plugin.prepareToPlay(sampleRate, blockSize);
+
+    const int latency = plugin.getLatencySamples();
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+
+    auto renderBlock = [&] {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::fill(buffer.getWritePointer(ch), level, blockSize);
+        plugin.processBlock(buffer, midi);
+    };
+
+    renderBlock(); // Fills the latency with the dry signal
+
+    // 140 snaps down to the 128 grid point
+    const int postedOffset = 140;
+    const int appliedOffset = postedOffset / ParameterEventQueue::minSubBlockSamples * ParameterEventQueue::minSubBlockSamples;
+    const int step = appliedOffset + latency;
+
+    int failures = 0;
+    failures += check(! plugin.postParameterChange("NO_SUCH_PARAMETER", 1.0f, 0), "Unknown ID accepted");
+    failures += check(plugin.postParameterChange("MIX", 1.0f, postedOffset), "MIX change rejected");
+
+    failures += check(step < blockSize, "Latency too long for the test block");
+    renderBlock();
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        const float* out = buffer.getReadPointer(ch);
+
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const float expected = i < step ? level : 0.0f;
+            if (std::abs(out[i] - expected) > tolerance)
+            {
+                std::cerr << "Channel " << ch << " sample " << i << " is " << out[i] << ", expected " << expected
+                          << " (step at " << step << ")" << std::endl;
+                ++failures;
+                break;
+            }
+        }
+    }
+
+    const float mix = plugin.getAPVTS().getRawParameterValue("MIX")->load();
+    failures += check(std::abs(mix - 100.0f) < tolerance, "APVTS MIX is " + juce::String(mix) + ", expected 100");
+
+    std::cout << (failures == 0 ? "Passed" : "Failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "../Source/PluginProcessor.h"
+#include <iostream>
+// cmake --build build --config Debug --target PresetLibraryTest
+//
+// Checks PresetLibrary against a temporary folder of presets: the first scan
+// parses them and writes the index, a second library reads them back from
+// the index unchanged, search matches names and tags, and findSimilar ranks
+// by distance over the sound-shaping parameters only. A preset that sets
+// only some parameters must leave the others alone whether it is loaded from
+// the file or from the index.
+
+namespace
+{
+    constexpr float tolerance = 1.0e-4f;
+
+    int check(bool condition, const juce::String& message)
+    {
+        if (! condition)
+            std::cerr << message << std::endl;
+        return condition ? 0 : 1;
+    }
+
+    // The scan runs on the library's thread
+    std::shared_ptr<const PresetLibrary::Snapshot> waitForScan(const PresetLibrary& library)
+    {
+        for (int i = 0; i < 500 && ! library.hasScanned(); ++i)
+            juce::Thread::sleep(10);
+
+        return library.getSnapshot();
+    }
+
+    const PresetLibrary::Entry* findByName(const PresetLibrary::Snapshot& snapshot, const juce::String& name)
+    {
+        for (auto& entry : snapshot)
+            if (entry.name == name)
+                return &entry;
+        return nullptr;
+    }
+
+    void savePreset(FDNRAudioProcessor& plugin, const juce::File& folder, const juce::String& name,
+                    float mix, float feedback, const juce::StringArray& tags)
+    {
+        plugin.resetAllParametersToDefault();
+        plugin.getAPVTS().getParameterAsValue("MIX").setValue(mix);
+        plugin.getAPVTS().getParameterAsValue("FEEDBACK").setValue(feedback);
+        plugin.savePreset(folder.getChildFile(name + ".json"), tags);
+    }
+
+    float plainValue(FDNRAudioProcessor& plugin, const juce::String& id)
+    {
+        return plugin.getAPVTS().getRawParameterValue(id)->load();
+    }
+}
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                            .getNonexistentChildFile("FDNRPresetLibraryTest", {}, false);
+    folder.createDirectory();
+
+    FDNRAudioProcessor plugin;
+    savePreset(plugin, folder, "Big Hall", 60.0f, 90.0f, { "hall", "long" });
+    savePreset(plugin, folder, "Small Room", 30.0f, 20.0f, { "room" });
+    savePreset(plugin, folder, "Wide Hall", 55.0f, 80.0f, { "hall", "wide" });
+
+    // Sounds like Big Hall, but every engine and workflow setting differs
+    plugin.resetAllParametersToDefault();
+    plugin.getAPVTS().getParameterAsValue("MIX").setValue(60.0f);
+    plugin.getAPVTS().getParameterAsValue("FEEDBACK").setValue(90.0f);
+    plugin.getAPVTS().getParameterAsValue("QUALITY").setValue(0.0f);
+    plugin.getAPVTS().getParameterAsValue("REVERB_RATE").setValue(2.0f);
+    plugin.getAPVTS().getParameterAsValue("ON_STOP").setValue(1.0f);
+    plugin.getAPVTS().getParameterAsValue("FREEZE").setValue(true);
+    plugin.getAPVTS().getParameterAsValue("AB_SWITCH").setValue(true);
+    plugin.savePreset(folder.getChildFile("Eco Copy.json"), { "copy" });
+
+    // Sets MIX only
+    folder.getChildFile("Partial.json").replaceWithText(R"({ "name": "Partial", "parameters": { "MIX": 10.0 } })");
+
+    const auto space = PresetLibrary::ParameterSpace::fromProcessor(plugin, FDNRAudioProcessor::getNonSoundParameterIDs());
+    int failures = 0;
+
+    std::shared_ptr<const PresetLibrary::Snapshot> parsed;
+    {
+        PresetLibrary library(folder, space);
+        parsed = waitForScan(library);
+    }
+
+    failures += check(parsed->size() == 5, "First scan found " + juce::String((int)parsed->size()) + " presets, expected 5");
+    failures += check(folder.getChildFile(PresetLibrary::indexFileName).existsAsFile(), "No index written");
+
+    // Index round-trip: nothing changed on disk, so every entry comes from the index
+    std::shared_ptr<const PresetLibrary::Snapshot> indexed;
+    {
+        PresetLibrary library(folder, space);
+        indexed = waitForScan(library);
+    }
+
+    failures += check(indexed->size() == parsed->size(), "Index returned a different number of presets");
+
+    for (size_t i = 0; i < juce::jmin(indexed->size(), parsed->size()); ++i)
+    {
+        const auto& a = (*parsed)[i];
+        const auto& b = (*indexed)[i];
+        bool same = a.name == b.name && a.tags == b.tags && a.stored == b.stored && a.values.size() == b.values.size();
+
+        for (size_t v = 0; same && v < a.values.size(); ++v)
+            same = std::abs(a.values[v] - b.values[v]) < tolerance;
+
+        failures += check(same, "Indexed entry for " + a.name + " differs from the parsed one");
+    }
+
+    // Search: every word must match the name or a tag
+    auto names = [](const std::vector<const PresetLibrary::Entry*>& entries) {
+        juce::StringArray result;
+        for (auto* entry : entries)
+            result.add(entry->name);
+        return result.joinIntoString(", ");
+    };
+
+    failures += check(names(PresetLibrary::search(*indexed, "HALL")) == "Big Hall, Wide Hall", "Search 'HALL' returned " + names(PresetLibrary::search(*indexed, "HALL")));
+    failures += check(names(PresetLibrary::search(*indexed, "hall wide")) == "Wide Hall", "Search 'hall wide' returned " + names(PresetLibrary::search(*indexed, "hall wide")));
+    failures += check(names(PresetLibrary::search(*indexed, "room")) == "Small Room", "Search 'room' returned " + names(PresetLibrary::search(*indexed, "room")));
+    failures += check(PresetLibrary::search(*indexed, "plate").empty(), "Search 'plate' matched");
+    failures += check(PresetLibrary::search(*indexed, {}).size() == indexed->size(), "Empty search did not match everything");
+
+    // Similarity: Big Hall sounds the same as Eco Copy, and differs from Wide
+    // Hall by 0.05 (MIX) and 0.1 (FEEDBACK), from Partial by 0.5 and 0.4,
+    // from Small Room by 0.3 and 0.7
+    const auto* bigHall = findByName(*indexed, "Big Hall");
+    failures += check(bigHall != nullptr, "Big Hall missing");
+
+    if (bigHall != nullptr)
+    {
+        const auto similar = PresetLibrary::findSimilar(*indexed, space, bigHall->values, 3, bigHall);
+        failures += check(names(similar) == "Eco Copy, Wide Hall, Partial", "Similar to Big Hall returned " + names(similar));
+    }
+
+    // Loading a partial preset leaves what it does not set alone, on both paths
+    const auto* partial = findByName(*indexed, "Partial");
+    failures += check(partial != nullptr, "Partial missing");
+
+    if (partial != nullptr)
+    {
+        plugin.resetAllParametersToDefault();
+        plugin.getAPVTS().getParameterAsValue("WIDTH").setValue(40.0f);
+        plugin.loadPreset(partial->file);
+        const float widthFromFile = plainValue(plugin, "WIDTH");
+        const float mixFromFile = plainValue(plugin, "MIX");
+
+        plugin.resetAllParametersToDefault();
+        plugin.getAPVTS().getParameterAsValue("WIDTH").setValue(40.0f);
+        plugin.loadPreset(*partial);
+
+        failures += check(std::abs(widthFromFile - 40.0f) < tolerance, "Loading the file changed WIDTH to " + juce::String(widthFromFile));
+        failures += check(std::abs(plainValue(plugin, "WIDTH") - 40.0f) < tolerance, "Loading the entry changed WIDTH to " + juce::String(plainValue(plugin, "WIDTH")));
+        failures += check(std::abs(mixFromFile - 10.0f) < tolerance, "Loading the file set MIX to " + juce::String(mixFromFile));
+        failures += check(std::abs(plainValue(plugin, "MIX") - 10.0f) < tolerance, "Loading the entry set MIX to " + juce::String(plainValue(plugin, "MIX")));
+    }
+
+    folder.deleteRecursively();
+
+    std::cout << (failures == 0 ? "Passed" : "Failed") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "OfflineRenderer.h"
+#include <atomic>
+#include <iostream>
+// cmake --build build --config Release --target FDNRBatchRender
+//
+// Renders a manifest of (input, preset, output) jobs on every core:
+//
+//     FDNRBatchRender manifest.json [--threads N] [--block N]
+//
+// manifest.json:
+//     { "jobs": [ { "input": "dry/kick.wav", "preset": "presets/Hall.json",
+//                   "output": "wet/kick_hall.wav", "tail": 2.5,
+//                   "automation": [ { "parameter": "MIX", "time": 1.5, "value": 30 } ] }, ... ] }
+//
+// Relative paths are resolved against the manifest's folder; "tail" (seconds
+// rendered past the end of the input) and "automation" (plain parameter
+// values at times in the input, applied sample-accurately) are optional. Each worker thread owns
+// one plugin instance and takes the next job from a shared counter, so long
+// and short files balance across the cores. Reads are buffered ahead and
+// writes are flushed by two shared background threads.
+
+namespace
+{
+    juce::CriticalSection consoleLock;
+
+    class RenderWorker : public juce::Thread
+    {
+    public:
+        RenderWorker(int index, const std::vector<OfflineRenderer::Job>& jobsToRender, std::vector<juce::String>& jobErrors,
+                     std::atomic<int>& next, juce::TimeSliceThread& readAhead, juce::TimeSliceThread& writer, int blockSize)
+            : juce::Thread("Render worker " + juce::String(index)),
+              jobs(jobsToRender), errors(jobErrors), nextJob(next), renderer(readAhead, writer, blockSize)
+        {
+        }
+
+        void run() override
+        {
+            for (int i = nextJob++; i < (int)jobs.size() && ! threadShouldExit(); i = nextJob++)
+            {
+                const auto& job = jobs[(size_t)i];
+                auto result = renderer.render(job);
+
+                // Each job's slot is written by exactly one worker
+                if (result.failed())
+                    errors[(size_t)i] = result.getErrorMessage();
+
+                const juce::ScopedLock sl(consoleLock);
+                std::cout << "[" << (i + 1) << "/" << jobs.size() << "] "
+                          << (result.wasOk() ? "OK   " : "FAIL ") << job.output.getFileName() << std::endl;
+            }
+        }
+
+    private:
+        const std::vector<OfflineRenderer::Job>& jobs;
+        std::vector<juce::String>& errors;
+        std::atomic<int>& nextJob;
+        OfflineRenderer renderer;
+    };
+
+    bool parseManifest(const juce::File& manifest, std::vector<OfflineRenderer::Job>& jobs)
+    {
+        auto json = juce::JSON::parse(manifest);
+        auto* jobList = json.getProperty("jobs", juce::var()).getArray();
+        if (jobList == nullptr)
+            return false;
+
+        const auto baseDir = manifest.getParentDirectory();
+
+        for (auto& entry : *jobList)
+        {
+            OfflineRenderer::Job job;
+            job.input = baseDir.getChildFile(entry.getProperty("input", "").toString());
+            job.preset = baseDir.getChildFile(entry.getProperty("preset", "").toString());
+            job.output = baseDir.getChildFile(entry.getProperty("output", "").toString());
+            job.tailSeconds = (double)entry.getProperty("tail", job.tailSeconds);
+
+            if (auto* points = entry.getProperty("automation", juce::var()).getArray())
+                for (auto& point : *points)
+                    job.automation.push_back({ point.getProperty("parameter", "").toString(),
+                                               (double)point.getProperty("time", 0.0),
+                                               (float)point.getProperty("value", 0.0f) });
+            jobs.push_back(job);
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    if (args.isEmpty())
+    {
+        std::cerr << "Usage: FDNRBatchRender manifest.json [--threads N] [--block N]" << std::endl;
+        return 2;
+    }
+
+    const auto manifest = juce::File::getCurrentWorkingDirectory().getChildFile(args[0]);
+
+    auto optionValue = [&](const juce::String& name, int fallback) {
+        const int index = args.indexOf(name);
+        return index >= 0 && index + 1 < args.size() ? args[index + 1].getIntValue() : fallback;
+    };
+
+    const int numThreads = juce::jmax(1, optionValue("--threads", juce::SystemStats::getNumCpus()));
+    const int blockSize = juce::jlimit(32, 65536, optionValue("--block", 4096));
+
+    std::vector<OfflineRenderer::Job> jobs;
+    if (! parseManifest(manifest, jobs))
+    {
+        std::cerr << "No \"jobs\" array in " << manifest.getFullPathName() << std::endl;
+        return 2;
+    }
+
+    juce::TimeSliceThread readAheadThread("Read-ahead");
+    juce::TimeSliceThread writerThread("Writer");
+    readAheadThread.startThread();
+    writerThread.startThread();
+
+    std::vector<juce::String> errors(jobs.size());
+    std::atomic<int> nextJob { 0 };
+
+    // Plugin instances are created here on the main thread, then only used by their worker
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+    for (int i = 0; i < juce::jmin(numThreads, (int)jobs.size()); ++i)
+        workers.push_back(std::make_unique<RenderWorker>(i, jobs, errors, nextJob, readAheadThread, writerThread, blockSize));
+
+    const double start = juce::Time::getMillisecondCounterHiRes();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    const double seconds = (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+
+    int failed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        if (errors[i].isNotEmpty())
+        {
+            std::cerr << jobs[i].output.getFullPathName() << ": " << errors[i] << std::endl;
+            ++failed;
+        }
+    }
+
+    std::cout << jobs.size() << " jobs on " << workers.size() << " threads in " << juce::String(seconds, 1) << " s, "
+              << failed << " failed" << std::endl;
+
+    return failed == 0 ? 0 : 1;
+}
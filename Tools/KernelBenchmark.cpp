@@ -0,0 +1,138 @@
+#include <juce_core/juce_core.h>
+#include "../Source/DspKernels.h"
+#include <iostream>
+// cmake --build build --config Release --target FDNRKernelBenchmark
+//
+// Times every DspKernels variant this CPU can run against the baseline build
+// and checks they agree:
+//
+//     FDNRKernelBenchmark [--samples N] [--repeats N]
+//
+// Prints ns per sample (per call for dot16), the speedup over the baseline
+// and the largest difference from the baseline's output. The variant marked
+// '*' is the one the plugin uses on this machine.
+
+namespace
+{
+    struct Buffers
+    {
+        std::vector<float> left, right, out;
+
+        Buffers(int numSamples, juce::Random& random)
+            : left((size_t)numSamples), right((size_t)numSamples), out((size_t)numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                left[(size_t)i] = random.nextFloat() * 2.0f - 1.0f;
+                right[(size_t)i] = random.nextFloat() * 2.0f - 1.0f;
+            }
+        }
+    };
+
+    struct Result
+    {
+        double nanoseconds = 0.0;
+        std::vector<float> output;
+    };
+
+    // Runs one kernel 'repeats' times on fresh copies of the inputs and keeps
+    // the fastest pass, which is the least disturbed by the rest of the system.
+    template <typename Kernel>
+    Result time(const Buffers& source, int repeats, int units, Kernel&& kernel)
+    {
+        Result result;
+        result.nanoseconds = std::numeric_limits<double>::max();
+
+        for (int r = 0; r < repeats; ++r)
+        {
+            Buffers work = source;
+            const auto start = juce::Time::getHighResolutionTicks();
+            kernel(work);
+            const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+            result.nanoseconds = juce::jmin(result.nanoseconds, juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e9 / units);
+            result.output = work.out;
+            result.output.insert(result.output.end(), work.left.begin(), work.left.end());
+            result.output.insert(result.output.end(), work.right.begin(), work.right.end());
+        }
+
+        return result;
+    }
+
+    float maxDifference(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        float diff = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+            diff = juce::jmax(diff, std::abs(a[i] - b[i]));
+        return diff;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    auto optionValue = [&](const juce::String& name, int fallback) {
+        const int index = args.indexOf(name);
+        return index >= 0 && index + 1 < args.size() ? args[index + 1].getIntValue() : fallback;
+    };
+
+    const int numSamples = juce::jmax(64, optionValue("--samples", 1 << 16)) & ~15;
+    const int repeats = juce::jmax(1, optionValue("--repeats", 50));
+    const int numDots = numSamples / 16;
+
+    juce::Random random(1234);
+    const Buffers source(numSamples, random);
+
+    const DspKernels* available[DspKernels::maxVariants] = {};
+    const juce::Array<const DspKernels*> variants(available, DspKernels::getAvailable(available));
+    const auto* selected = &DspKernels::get();
+
+    using Run = std::function<void(const DspKernels&, Buffers&)>;
+    const std::pair<const char*, Run> kernels[] = {
+        { "linkedPeak", [&](const DspKernels& k, Buffers& b) { k.linkedPeak(b.left.data(), b.right.data(), b.out.data(), numSamples); } },
+        { "midSide",    [&](const DspKernels& k, Buffers& b) { k.midSide(b.left.data(), b.right.data(), numSamples, 0.7f, 1.3f); } },
+        { "mix",        [&](const DspKernels& k, Buffers& b) { k.mix(b.left.data(), b.right.data(), 0.6f, 0.4f, numSamples); } },
+        { "dot16",      [&](const DspKernels& k, Buffers& b) {
+              for (int i = 0; i < numDots; ++i)
+                  b.out[(size_t)i] = k.dot16(b.left.data() + 16 * i, b.right.data() + 16 * i);
+          } },
+    };
+
+    std::cout << "CPU: " << juce::SystemStats::getCpuModel() << std::endl
+              << numSamples << " samples, best of " << repeats << std::endl << std::endl;
+
+    bool ok = true;
+
+    for (auto& [kernelName, run] : kernels)
+    {
+        const int units = juce::String(kernelName) == "dot16" ? numDots : numSamples;
+        Result baseline;
+
+        for (auto* variant : variants)
+        {
+            auto result = time(source, repeats, units, [&](Buffers& b) { run(*variant, b); });
+
+            if (variant == variants.getFirst())
+                baseline = result;
+
+            const float diff = maxDifference(result.output, baseline.output);
+            ok = ok && diff < 1.0e-5f;
+
+            std::cout << juce::String(kernelName).paddedRight(' ', 12)
+                      << juce::String(variant->name).paddedRight(' ', 9) << (variant == selected ? "* " : "  ")
+                      << juce::String(result.nanoseconds, 3).paddedLeft(' ', 8) << " ns  "
+                      << juce::String(baseline.nanoseconds / result.nanoseconds, 2).paddedLeft(' ', 6) << "x  "
+                      << "max diff " << diff << std::endl;
+        }
+
+        std::cout << std::endl;
+    }
+
+    if (! ok)
+        std::cerr << "Variants disagree with the baseline" << std::endl;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "../Source/PluginProcessor.h"
+#include <iostream>
+// cmake --build build --config Release --target FDNRLoadBenchmark
+//
+// Times what a host does when it opens a session with many instances:
+//
+//     FDNRLoadBenchmark [--rate HZ] [--block N] [--repeats N]
+//
+// For 1, 10 and 100 instances it constructs them, restores a saved state,
+// prepares them, prepares them again with the same spec (hosts do this on
+// transport starts and bypass toggles) and deletes them. Prints the best
+// time of each step per instance, in milliseconds.
+
+namespace
+{
+    struct Timings
+    {
+        double construct = 0.0, restore = 0.0, prepare = 0.0, reprepare = 0.0, destroy = 0.0;
+    };
+
+    double secondsSince(juce::int64 startTicks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    }
+
+    Timings loadOnce(int numInstances, const juce::MemoryBlock& state, double sampleRate, int blockSize)
+    {
+        Timings t;
+        std::vector<std::unique_ptr<FDNRAudioProcessor>> instances;
+        instances.reserve((size_t)numInstances);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<FDNRAudioProcessor>());
+        t.construct = secondsSince(start);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (auto& instance : instances)
+            instance->setStateInformation(state.getData(), (int)state.getSize());
+        t.restore = secondsSince(start);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (auto& instance : instances)
+            instance->prepareToPlay(sampleRate, blockSize);
+        t.prepare = secondsSince(start);
+
+        start = juce::Time::getHighResolutionTicks();
+        for (auto& instance : instances)
+            instance->prepareToPlay(sampleRate, blockSize);
+        t.reprepare = secondsSince(start);
+
+        start = juce::Time::getHighResolutionTicks();
+        instances.clear();
+        t.destroy = secondsSince(start);
+
+        return t;
+    }
+
+    void keepBest(Timings& best, const Timings& t)
+    {
+        best.construct = juce::jmin(best.construct, t.construct);
+        best.restore = juce::jmin(best.restore, t.restore);
+        best.prepare = juce::jmin(best.prepare, t.prepare);
+        best.reprepare = juce::jmin(best.reprepare, t.reprepare);
+        best.destroy = juce::jmin(best.destroy, t.destroy);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    auto optionValue = [&](const juce::String& name, double fallback) {
+        const int index = args.indexOf(name);
+        return index >= 0 && index + 1 < args.size() ? args[index + 1].getDoubleValue() : fallback;
+    };
+
+    const double sampleRate = juce::jmax(8000.0, optionValue("--rate", 48000.0));
+    const int blockSize = juce::jmax(16, (int)optionValue("--block", 512));
+    const int repeats = juce::jmax(1, (int)optionValue("--repeats", 5));
+
+    // A non-default state, as a saved session would hold
+    juce::MemoryBlock state;
+    {
+        FDNRAudioProcessor source;
+        source.setParametersForMode(4);
+        source.getStateInformation(state);
+    }
+
+    std::cout << "CPU: " << juce::SystemStats::getCpuModel() << std::endl
+              << sampleRate << " Hz, " << blockSize << " samples, best of " << repeats << ", ms per instance"
+              << std::endl << std::endl
+              << "instances  construct    restore    prepare  re-prepare    destroy" << std::endl;
+
+    for (int numInstances : { 1, 10, 100 })
+    {
+        constexpr double none = std::numeric_limits<double>::max();
+        Timings best { none, none, none, none, none };
+
+        for (int r = 0; r < repeats; ++r)
+            keepBest(best, loadOnce(numInstances, state, sampleRate, blockSize));
+
+        auto column = [&](double seconds, int width) {
+            return juce::String(seconds * 1000.0 / numInstances, 3).paddedLeft(' ', width);
+        };
+
+        std::cout << juce::String(numInstances).paddedLeft(' ', 9)
+                  << column(best.construct, 11) << column(best.restore, 11) << column(best.prepare, 11)
+                  << column(best.reprepare, 12) << column(best.destroy, 11) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "OfflineRenderer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    constexpr int readAheadSamples = 65536;
+    constexpr int writerFifoSamples = 65536;
+    constexpr int maxOutputChannels = 8;
+
+    // Memory-mapped inputs are mapped this many samples at a time (about 22 s
+    // at 48 kHz), so the address space and page cache used stay bounded
+    // however long the file is.
+    constexpr juce::int64 mapWindowSamples = 1 << 20;
+}
+
+OfflineRenderer::OfflineRenderer(juce::TimeSliceThread& readAhead, juce::TimeSliceThread& writer, int samplesPerBlock)
+    : readAheadThread(readAhead), writerThread(writer), blockSize(samplesPerBlock)
+{
+    formatManager.registerBasicFormats();
+}
+
+juce::Result OfflineRenderer::render(const Job& job)
+{
+    // Input: uncompressed WAV/AIFF are memory-mapped a window at a time, other
+    // formats are decoded through a read-ahead buffer.
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader;
+    if (auto* format = formatManager.findFormatForFileExtension(job.input.getFileExtension()))
+        mappedReader.reset(format->createMemoryMappedReader(job.input));
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (mappedReader == nullptr)
+        reader.reset(formatManager.createReaderFor(job.input));
+
+    juce::AudioFormatReader* source = mappedReader != nullptr ? mappedReader.get() : reader.get();
+    if (source == nullptr)
+        return juce::Result::fail("Cannot read " + job.input.getFullPathName());
+
+    if (! job.preset.existsAsFile())
+        return juce::Result::fail("Missing preset " + job.preset.getFullPathName());
+
+    // Automation in time order; the sort is stable, so points at the same
+    // time apply in manifest order
+    auto automation = job.automation;
+    std::stable_sort(automation.begin(), automation.end(),
+                     [](const AutomationPoint& a, const AutomationPoint& b) { return a.time < b.time; });
+
+    for (auto& point : automation)
+        if (processor.getAPVTS().getParameter(point.parameterID) == nullptr)
+            return juce::Result::fail("Unknown automation parameter " + point.parameterID);
+
+    // Start from defaults so nothing carries over from the previous job's preset
+    processor.resetAllParametersToDefault();
+    processor.loadPreset(job.preset);
+
+    const double sampleRate = source->sampleRate;
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const int numChannels = processor.getMainBusNumOutputChannels();
+    jassert(numChannels <= maxOutputChannels);
+    buffer.setSize(numChannels, blockSize, false, false, true);
+
+    // Output
+    job.output.getParentDirectory().createDirectory();
+    job.output.deleteFile();
+
+    std::unique_ptr<juce::OutputStream> stream(job.output.createOutputStream());
+    if (stream == nullptr)
+        return juce::Result::fail("Cannot write " + job.output.getFullPathName());
+
+    // Past 4 GB of sample data the WAV writer rewrites the header as RF64 when
+    // it closes; this needs the seekable FileOutputStream created above.
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, 24, {}, 0));
+    if (writer == nullptr)
+        return juce::Result::fail("Cannot create a WAV writer for " + job.output.getFullPathName());
+
+    stream.release(); // Owned by the writer now
+
+    const juce::int64 inputLength = source->lengthInSamples;
+    const juce::int64 latency = processor.getLatencySamples();
+    const juce::int64 outputLength = inputLength + (juce::int64)(job.tailSeconds * sampleRate);
+
+    // The writer flushes and closes the file when this goes out of scope
+    juce::AudioFormatWriter::ThreadedWriter output(writer.release(), writerThread, writerFifoSamples);
+
+    std::unique_ptr<juce::BufferingAudioReader> bufferedReader;
+    if (reader != nullptr)
+    {
+        bufferedReader = std::make_unique<juce::BufferingAudioReader>(reader.release(), readAheadThread, readAheadSamples);
+        bufferedReader->setReadTimeout(-1); // Offline: wait for the disk rather than read silence
+        source = bufferedReader.get();
+    }
+
+    juce::MidiBuffer midi;
+    const juce::int64 totalSamples = outputLength + latency;
+    size_t nextPoint = 0;
+
+    for (juce::int64 pos = 0; pos < totalSamples; pos += blockSize)
+    {
+        const int numSamples = (int)juce::jmin((juce::int64)blockSize, totalSamples - pos);
+
+        buffer.clear();
+        if (pos < inputLength)
+        {
+            const int numToRead = (int)juce::jmin((juce::int64)numSamples, inputLength - pos);
+
+            if (mappedReader != nullptr && ! mappedReader->getMappedSection().contains({ pos, pos + numToRead }))
+                if (! mappedReader->mapSectionOfFile({ pos, juce::jmin(inputLength, pos + juce::jmax(mapWindowSamples, (juce::int64)numToRead)) }))
+                    return juce::Result::fail("Cannot map " + job.input.getFullPathName());
+
+            source->read(&buffer, 0, numToRead, pos, true, true);
+        }
+
+        // Automation points falling in this block, at their sample offsets
+        while (nextPoint < automation.size())
+        {
+            const auto& point = automation[nextPoint];
+            const auto at = (juce::int64)std::llround(point.time * sampleRate);
+            if (at >= pos + numSamples)
+                break;
+
+            const float normalised = processor.getAPVTS().getParameter(point.parameterID)->convertTo0to1(point.value);
+            if (! processor.postParameterChange(point.parameterID, normalised, (int)juce::jmax((juce::int64)0, at - pos)))
+                break; // Queue full: the rest apply at the start of the next block
+
+            ++nextPoint;
+        }
+
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, 0, numSamples);
+        processor.processBlock(block, midi);
+
+        // Drop the first 'latency' samples so the output lines up with the input
+        const int skip = (int)juce::jlimit((juce::int64)0, (juce::int64)numSamples, latency - pos);
+        if (skip == numSamples)
+            continue;
+
+        const float* channels[maxOutputChannels] = {};
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch] = buffer.getReadPointer(ch, skip);
+
+        while (! output.write(channels, numSamples - skip))
+            juce::Thread::sleep(1); // Writer FIFO full: let the disk catch up
+    }
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "../Source/PluginProcessor.h"
+
+// Headless render of audio files through one plugin instance. WAV and AIFF
+// inputs are memory-mapped a window at a time, other formats stream through
+// a read-ahead buffer. The output goes to disk through a background writer and
+// becomes RF64 past 4 GB. Memory use is bounded whatever the file length, and
+// the render loop only waits on the disk when a buffer runs dry.
+//
+// An OfflineRenderer is not thread-safe; give each worker thread its own.
+class OfflineRenderer
+{
+public:
+    // A parameter set to a plain value at a time in the input, in seconds
+    struct AutomationPoint
+    {
+        juce::String parameterID;
+        double time = 0.0;
+        float value = 0.0f;
+    };
+
+    struct Job
+    {
+        juce::File input;
+        juce::File preset;        // JSON written by FDNRAudioProcessor::savePreset
+        juce::File output;        // .wav
+        double tailSeconds = 3.0; // rendered past the end of the input
+
+        // Applied sample-accurately on top of the preset, through
+        // FDNRAudioProcessor::postParameterChange
+        std::vector<AutomationPoint> automation;
+    };
+
+    // The threads do the read-ahead and the output writes; they may be shared
+    // between renderers and must be running.
+    OfflineRenderer(juce::TimeSliceThread& readAheadThread, juce::TimeSliceThread& writerThread, int blockSize = 4096);
+
+    juce::Result render(const Job& job);
+
+private:
+    FDNRAudioProcessor processor;
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread& readAheadThread;
+    juce::TimeSliceThread& writerThread;
+    const int blockSize;
+    juce::AudioBuffer<float> buffer;
+};
@@ -0,0 +1,120 @@
+#include <juce_audio_utils/juce_audio_utils.h>
+#include "../Source/ReverbProcessor.h"
+#include <iostream>
+// cmake --build build --config Release --target FDNRSilenceBenchmark
+//
+// Denormal stress test: a loud burst, then silence, through the DSP core with
+// every recursive stage running and the CPU's flush-to-zero switched off, as
+// on a host that does not honour ScopedNoDenormals:
+//
+//     FDNRSilenceBenchmark [--seconds N] [--rate HZ] [--block N] [--limit X]
+//
+// Prints the cost of each second of the decay relative to the first one. A
+// tail falling into the denormal range shows up as a late second costing
+// 10-100x more; the exit code is 1 if any second costs more than --limit
+// (default 2) times the first.
+
+namespace
+{
+    ReverbParameters stressParameters(double bpm)
+    {
+        ReverbParameters p;
+        p.mode = 4; // Void Maker: near-infinite decay
+        p.feedback = 100.0f;
+        p.mix = 100.0f;
+        p.saturation = 20.0f;
+        p.gateThresh = -60.0f;
+        p.dynGain = 3.0f;
+        p.dynDepth = 6.0f;
+        p.ducking = 30.0f;
+        p.eq3Low = 3.0f;
+        p.eq3High = -3.0f;
+        p.msBalance = 60.0f;
+        p.bpm = bpm;
+        return p;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    auto optionValue = [&](const juce::String& name, double fallback) {
+        const int index = args.indexOf(name);
+        return index >= 0 && index + 1 < args.size() ? args[index + 1].getDoubleValue() : fallback;
+    };
+
+    const double sampleRate = juce::jmax(8000.0, optionValue("--rate", 48000.0));
+    const int blockSize = juce::jmax(16, (int)optionValue("--block", 512));
+    const int seconds = juce::jmax(2, (int)optionValue("--seconds", 60));
+    const double limit = optionValue("--limit", 2.0);
+
+    // What a host that ignores FTZ/DAZ leaves the audio thread with
+    juce::FloatVectorOperations::disableDenormalisedNumberSupport(false);
+
+    ReverbProcessor reverb;
+    reverb.prepare({ sampleRate, (juce::uint32)blockSize, 2 });
+    reverb.setParameters(stressParameters(120.0));
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::Random random(1234);
+    const int samplesPerSecond = (int)sampleRate;
+    const int burstSamples = samplesPerSecond / 2;
+
+    auto renderSecond = [&](int second) {
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int done = 0; done < samplesPerSecond; done += blockSize)
+        {
+            const int n = juce::jmin(blockSize, samplesPerSecond - done);
+            buffer.clear();
+
+            // 0 dBFS noise for the first half second, then digital silence
+            if (second == 0)
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < n && done + i < burstSamples; ++i)
+                        buffer.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+            juce::dsp::AudioBlock<float> block(buffer.getArrayOfWritePointers(), 2, (size_t)n);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+            reverb.process(context);
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    };
+
+    renderSecond(0); // The burst
+
+    std::cout << sampleRate << " Hz, " << blockSize << " samples, flush-to-zero off" << std::endl << std::endl
+              << "second    ms   vs first" << std::endl;
+
+    double first = 0.0, worst = 0.0;
+
+    for (int second = 1; second < seconds; ++second)
+    {
+        const double elapsed = renderSecond(second);
+        if (second == 1)
+            first = elapsed;
+
+        const double ratio = elapsed / juce::jmax(first, 1.0e-9);
+        worst = juce::jmax(worst, ratio);
+
+        std::cout << juce::String(second).paddedLeft(' ', 6)
+                  << juce::String(elapsed * 1000.0, 2).paddedLeft(' ', 8)
+                  << juce::String(ratio, 2).paddedLeft(' ', 10) << "x" << std::endl;
+    }
+
+    std::cout << std::endl << "Slowest second: " << juce::String(worst, 2) << "x the first" << std::endl;
+
+    if (worst > limit)
+    {
+        std::cerr << "The decay got more than " << limit << "x slower" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}